@@ -18,12 +18,33 @@
 #include <deque>
 #include <sstream>
 #include <chrono>
-#include <regex>
+#include <ranges>
+#include <bit>
+#include <memory>
+#include <utility>
+#include <span>
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include "scan.h"
+#include "match.h"
+#include "thread_pool.h"
+#include "profile.h"
+#include "arena.h"
+#include "flat_hash.h"
+#include "bigint.h"
+#include "modular.h"
+#include "pages.h"
+#include "automaton.h"
+
 #include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #if !defined(DEBUG)
 #define DEBUG 0
@@ -190,7 +211,7 @@ namespace aoc {
         inline constexpr size_t hash(const T1& t1, const T2& t2) {
             size_t s1 = std::hash<T1>{}(t1);
             size_t s2 = std::hash<T2>{}(t2);
-            return s1 ^ s2 + 0x9e3779b9 + (s1 << 6) + (s1 >> 2);
+            return hashing::mix(hashing::mix(s1) ^ s2);
         }
     }
     template <typename T, typename... Ts>
@@ -209,9 +230,9 @@ namespace aoc {
         return ret;
     }
 
-    inline std::string_view trim(std::string_view sv) {
-        while (!sv.empty() && std::isspace(sv.front())) sv.remove_prefix(1);
-        while (!sv.empty() && std::isspace(sv.back())) sv.remove_suffix(1);
+    inline constexpr std::string_view trim(std::string_view sv) {
+        while (!sv.empty() && scan::is_space(sv.front())) sv.remove_prefix(1);
+        while (!sv.empty() && scan::is_space(sv.back())) sv.remove_suffix(1);
         return sv;
     }
 
@@ -224,27 +245,136 @@ namespace aoc {
         return std::string_view(the_string.data() + from, std::min(count, the_string.size() - from));
     }
 
+    // Lazy counterpart of str_split(): yields the same pieces, with the same
+    // max_splits semantics, without materializing them in a vector.
+    class split_view : public std::ranges::view_interface<split_view> {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string_view*;
+            using reference = std::string_view;
+
+            inline iterator() = default;
+            inline iterator(std::string_view sv, char sep, size_t max_splits)
+                : sv_(sv), scanner_(sv, sep), max_splits_(max_splits)
+            {
+                state_ = sv_.empty() ? State::end : State::normal;
+                next();
+            }
+
+            inline std::string_view operator*() const noexcept { return current_; }
+            inline const std::string_view* operator->() const noexcept { return &current_; }
+            inline iterator& operator++() noexcept {
+                next();
+                return *this;
+            }
+            inline iterator operator++(int) noexcept {
+                auto ret{*this};
+                next();
+                return ret;
+            }
+            inline bool operator==(const iterator& other) const noexcept {
+                return done_ == other.done_ && (done_ || current_.data() == other.current_.data());
+            }
+            inline bool operator==(std::default_sentinel_t) const noexcept { return done_; }
+
+        private:
+            enum class State { normal, rest, trailing, end };
+
+            std::string_view sv_{};
+            std::string_view current_{};
+            scan::Scanner scanner_{};
+            size_t max_splits_{0};
+            size_t start_{0};
+            size_t count_{0};
+            State state_{State::end};
+            bool done_{true};
+
+            inline void next() noexcept {
+                done_ = false;
+                switch (state_) {
+                    case State::normal: {
+                        auto end = scanner_.next(start_);
+                        current_ = substr(sv_, start_, end - start_);
+                        count_ += 1;
+                        if (end >= sv_.size()) {
+                            state_ = State::end;
+                            break;
+                        }
+                        start_ = end + 1;
+                        if (start_ >= sv_.size()) state_ = State::trailing;
+                        else if (count_ >= max_splits_ - 1) state_ = State::rest;
+                        break;
+                    }
+                    case State::rest: {
+                        current_ = substr(sv_, start_);
+                        state_ = State::end;
+                        break;
+                    }
+                    case State::trailing: {
+                        current_ = std::string_view(sv_.data() + sv_.size(), 0);
+                        state_ = State::end;
+                        break;
+                    }
+                    case State::end: {
+                        current_ = std::string_view();
+                        done_ = true;
+                        break;
+                    }
+                }
+            }
+        };
+
+        inline constexpr split_view() = default;
+        inline constexpr split_view(std::string_view the_string, char sep,
+                                    size_t max_splits = std::numeric_limits<size_t>::max())
+            : sv_(the_string), sep_(sep), max_splits_(max_splits)
+        {}
+
+        inline iterator begin() const { return iterator(sv_, sep_, max_splits_); }
+        inline constexpr std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+    private:
+        std::string_view sv_{};
+        char sep_{0};
+        size_t max_splits_{std::numeric_limits<size_t>::max()};
+    };
+
+    // Splits into exactly N pieces; anything else is reported as a failure.
+    template <size_t N>
+    inline std::optional<std::array<std::string_view, N>>
+    split_exact(std::string_view the_string, char sep) {
+        std::array<std::string_view, N> ret{};
+        size_t count{0};
+        for (auto piece : split_view(the_string, sep)) {
+            if (count >= N) return std::nullopt;
+            ret[count++] = piece;
+        }
+        if (count != N) return std::nullopt;
+        return ret;
+    }
+
     inline std::vector<std::string_view>
     str_split(std::string_view the_string, char sep,
               size_t max_splits = std::numeric_limits<size_t>::max())
     {
         std::vector<std::string_view> ret;
-        size_t start = 0;
-        size_t end = 0;
-        while (start < the_string.size()) {
-            end = the_string.find(sep, start);
-            ret.push_back(substr(the_string, start, end - start));
-            if (end >= the_string.size()) break;
-            start = end + 1;
-            if (ret.size() >= max_splits - 1) {
-                if (start < the_string.size())
-                    ret.push_back(substr(the_string, start));
-                break;
-            }
-        }
-        if (start == the_string.size() && !the_string.empty()) {
-            ret.push_back("");
-        }
+        for (auto piece : split_view(the_string, sep, max_splits))
+            ret.push_back(piece);
+        return ret;
+    }
+
+    // Same as above, with the vector allocated from `mr` (usually an aoc::Arena).
+    inline std::pmr::vector<std::string_view>
+    str_split(std::string_view the_string, char sep, std::pmr::memory_resource* mr,
+              size_t max_splits = std::numeric_limits<size_t>::max())
+    {
+        std::pmr::vector<std::string_view> ret(mr);
+        for (auto piece : split_view(the_string, sep, max_splits))
+            ret.push_back(piece);
         return ret;
     }
 
@@ -256,24 +386,6 @@ namespace aoc {
         return ret;
     }
 
-    template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
-    constexpr inline T gcd(T v1, T v2) {
-        T n1 = std::abs(std::max(v1, v2));
-        T n2 = std::abs(std::min(v1, v2));
-        if (!n2) return 1;
-        while (n2) {
-            T t = n1;
-            n1 = n2;
-            n2 = t % n2;
-        }
-        return n1;
-    }
-
-    template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
-    constexpr inline T lcm(T v1, T v2) {
-        return v1 * v2 / gcd(v1, v2);
-    }
-
     template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
     constexpr inline T bitmask(size_t size, size_t final_shift = 0) {
         T r{1};
@@ -296,51 +408,139 @@ namespace aoc {
         return end - start;
     }
 
-    inline std::string_view to_sv(std::cmatch::const_reference r) {
-        return std::string_view(r.first, r.length());
+    // time_call() that also adds the elapsed time to the profile timer `name`.
+    template <typename Callable, typename... Args>
+    inline std::chrono::nanoseconds profile_call(std::string_view name, const Callable& f, Args... args)
+    {
+        auto ret = time_call(f, args...);
+        profile::record(name, ret);
+        return ret;
     }
 
-    inline std::string_view to_sv(const std::string& s) {
-        return std::string_view(s);
+    // Human readable duration with three or four significant digits.
+    inline std::string format_duration(std::chrono::nanoseconds d) {
+        auto ns = uint64_t(d.count());
+        if (ns < 10'000) return fmt::format("{}ns", ns);
+        if (ns < 10'000'000) return fmt::format("{:.1f}us", double(ns) / 1e3);
+        if (ns < 10'000'000'000) return fmt::format("{:.1f}ms", double(ns) / 1e6);
+        return fmt::format("{:.2f}s", double(ns) / 1e9);
     }
 
-    inline std::vector<std::string_view>
-    str_split(std::string_view the_string, const std::regex& re,
-              size_t max_splits = std::numeric_limits<size_t>::max())
-    {
-        std::vector<std::string_view> ret{};
-        max_splits = std::max(size_t(2), max_splits);
-        while (true) {
-            std::cmatch r{};
-            if (!std::regex_search(the_string.begin(), the_string.end(), r, re)) {
-                ret.push_back(the_string);
-                break;
-            }
-            ret.push_back(to_sv(r.prefix()));
-            the_string = to_sv(r.suffix());
-            if (the_string.empty()) break;
-            if (ret.size() >= max_splits - 1) {
-                ret.push_back(the_string);
-                break;
-            }
-        }
-        return ret;
+    inline std::string_view to_sv(const std::string& s) {
+        return std::string_view(s);
     }
 
     template <typename T>
     inline bool from_chars(std::string_view sv, T& value, int base = 10) {
         auto rc = std::from_chars(sv.begin(), sv.end(), value, base);
-        return rc.ptr = sv.end();
+        return rc.ec == std::errc() && rc.ptr == sv.end();
     }
 
     template <typename T>
     inline std::optional<T> from_chars(std::string_view sv, int base = 10) {
         T ret{};
         auto rc = std::from_chars(sv.begin(), sv.end(), ret, base);
-        if (rc.ptr == sv.end()) return ret;
+        if (rc.ec == std::errc() && rc.ptr == sv.end()) return ret;
         return std::nullopt;
     }
 
+    namespace detail::swar {
+        // Number of leading bytes of `v` (in memory order) that are decimal
+        // digits, given v ^ 0x3030303030303030.
+        inline constexpr size_t leading_digits(uint64_t t) noexcept {
+            uint64_t flags = ((t + 0x7676767676767676llu) | t) & 0x8080808080808080llu;
+            return flags ? size_t(std::countr_zero(flags)) / 8 : 8;
+        }
+
+        // Decodes 8 digit values (one per byte, most significant first).
+        inline constexpr uint64_t decode8(uint64_t t) noexcept {
+            t = (t * 10) + (t >> 8);
+            return (((t & 0x000000ff000000ffllu) * 0x000f424000000064llu) +
+                    (((t >> 16) & 0x000000ff000000ffllu) * 0x0000271000000001llu)) >> 32;
+        }
+
+        inline constexpr uint64_t pow10(size_t n) noexcept {
+            uint64_t ret{1};
+            while (n--) ret *= 10;
+            return ret;
+        }
+
+        // Parses up to 8 digits at p; `digits` receives how many were consumed.
+        inline uint64_t parse8(const char* p, const char* end, size_t& digits) noexcept {
+            uint64_t v{0};
+            if (end - p >= 8) {
+                std::memcpy(&v, p, 8);
+            } else {
+                char tmp[8]{};
+                std::memcpy(tmp, p, size_t(end - p));
+                std::memcpy(&v, tmp, 8);
+            }
+            v ^= 0x3030303030303030llu;
+            digits = leading_digits(v);
+            if (!digits) return 0;
+            if (digits < 8) v <<= 8 * (8 - digits);
+            return decode8(v);
+        }
+    }
+
+    // Parses a list of decimal integers separated by `sep` and appends them to
+    // `values`. Whitespace around the numbers and blank entries are skipped.
+    // Digits are decoded 8 at a time. Mirrors std::from_chars(): on success
+    // ptr == sv.end(), otherwise ptr points at the offending number and ec is
+    // either invalid_argument or result_out_of_range. Works with any allocator,
+    // so std::pmr::vector outputs can live in an aoc::Arena.
+    template <typename T, typename Alloc, typename = std::enable_if_t<std::is_integral_v<T>>>
+    inline std::from_chars_result parse_ints(std::string_view sv, char sep, std::vector<T, Alloc>& values) {
+        using U = std::make_unsigned_t<T>;
+        const char* p = sv.data();
+        const char* end = sv.data() + sv.size();
+        const auto is_blank = [sep](char ch) { return ch != sep && scan::is_space(ch); };
+
+        while (p < end) {
+            while (p < end && is_blank(*p)) p++;
+            if (p == end) break;
+            if (*p == sep) {
+                p++;
+                continue;
+            }
+
+            const char* start = p;
+            bool negative{false};
+            if constexpr (std::is_signed_v<T>) {
+                if (*p == '-') {
+                    negative = true;
+                    p++;
+                }
+            }
+
+            size_t digits{0};
+            uint64_t value = detail::swar::parse8(p, end, digits);
+            if (!digits) return {start, std::errc::invalid_argument};
+            p += digits;
+            bool overflow{false};
+            while (digits == 8 && p < end) {
+                auto chunk = detail::swar::parse8(p, end, digits);
+                if (!digits) break;
+                overflow = overflow ||
+                    __builtin_mul_overflow(value, detail::swar::pow10(digits), &value) ||
+                    __builtin_add_overflow(value, chunk, &value);
+                p += digits;
+            }
+
+            auto limit = uint64_t(std::numeric_limits<T>::max()) + uint64_t(negative);
+            if (overflow || value > limit) return {start, std::errc::result_out_of_range};
+            values.push_back(negative ? T(U(0) - U(value)) : T(value));
+
+            while (p < end && is_blank(*p)) p++;
+            if (p < end) {
+                if (*p != sep) return {start, std::errc::invalid_argument};
+                p++;
+            }
+        }
+
+        return {end, std::errc()};
+    }
+
     template <typename T>
     inline constexpr std::pair<T, T> numeric_limits() {
         return std::make_pair(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
@@ -354,6 +554,252 @@ namespace aoc {
     inline constexpr size_t member_count(const T (&)[N]) noexcept {
         return N;
     }
+
+    // Command line of a solver: `--name=value` (or bare `--name`) options and
+    // positional arguments, the first of which is the input path.
+    class Params {
+    public:
+        inline Params() = default;
+        inline Params(int argc, char* argv[]) {
+            for (int i = 1; i < argc; i++) add(argv[i]);
+        }
+
+        inline void add(std::string_view arg) {
+            if (arg.size() > 2 && arg.starts_with("--")) {
+                arg.remove_prefix(2);
+                auto eq = arg.find('=');
+                if (eq == std::string_view::npos) set(arg, "");
+                else set(substr(arg, 0, eq), substr(arg, eq + 1));
+            } else {
+                positional_.emplace_back(arg);
+            }
+        }
+
+        inline void set(std::string_view name, std::string_view value) {
+            if (auto it = options_.find(name); it != options_.end())
+                it->second = std::string(value);
+            else
+                options_.emplace(std::string(name), std::string(value));
+        }
+
+        inline bool has(std::string_view name) const {
+            return options_.find(name) != options_.end();
+        }
+
+        inline std::optional<std::string_view> get(std::string_view name) const {
+            if (auto it = options_.find(name); it != options_.end()) return std::string_view(it->second);
+            return std::nullopt;
+        }
+
+        // Value of --name converted to T, or `def` if the option is missing.
+        // A malformed value is reported and also falls back to `def`.
+        template <typename T>
+        inline T get(std::string_view name, T def) const {
+            auto v = get(name);
+            if (!v) return def;
+            if constexpr (std::is_convertible_v<std::string_view, T>) {
+                return T(v.value());
+            } else {
+                T ret{};
+                if (from_chars(v.value(), ret)) return ret;
+                fmt::print(std::cerr, "Invalid value for --{}: '{}'\n", name, v.value());
+                return def;
+            }
+        }
+
+        inline const std::vector<std::string>& positional() const noexcept { return positional_; }
+
+    private:
+        std::map<std::string, std::string, std::less<>> options_{};
+        std::vector<std::string> positional_{};
+    };
+
+    // What a solver hands back: the printable answer of each part, plus the
+    // moment each one was produced so that runners can time the parts
+    // separately. Parsing the input is billed to part 1.
+    struct Answer {
+        using clock = std::chrono::steady_clock;
+
+        std::optional<std::string> part1{};
+        std::optional<std::string> part2{};
+        clock::time_point start{clock::now()};
+        clock::time_point part1_done{};
+        clock::time_point part2_done{};
+
+        template <typename T>
+        inline void set_part1(const T& value) {
+            part1 = fmt::format("{}", value);
+            part1_done = clock::now();
+        }
+
+        template <typename T>
+        inline void set_part2(const T& value) {
+            part2 = fmt::format("{}", value);
+            part2_done = clock::now();
+        }
+
+        inline std::chrono::nanoseconds part1_time() const noexcept {
+            return part1 ? part1_done - start : std::chrono::nanoseconds(0);
+        }
+
+        inline std::chrono::nanoseconds part2_time() const noexcept {
+            return part2 ? part2_done - (part1 ? part1_done : start) : std::chrono::nanoseconds(0);
+        }
+    };
+
+    // The whole puzzle input in one contiguous buffer. Regular files (either
+    // named on the command line or redirected to stdin) are mmap()-ed, anything
+    // else is slurped once. Lines and records are handed out as views into the
+    // buffer, so they stay valid for as long as the Input object is alive.
+    class Input {
+    public:
+        inline Input() = default;
+        inline explicit Input(std::string_view data) noexcept {
+            set_data(data);
+        }
+        inline Input(const Input&) = delete;
+        inline Input& operator=(const Input&) = delete;
+        inline Input(Input&& other) noexcept { *this = std::move(other); }
+        inline Input& operator=(Input&& other) noexcept {
+            if (this != &other) {
+                release();
+                buffer_ = std::move(other.buffer_);
+                mapping_ = std::exchange(other.mapping_, nullptr);
+                mapping_size_ = std::exchange(other.mapping_size_, 0);
+                data_ = std::exchange(other.data_, std::string_view());
+                newlines_ = std::exchange(other.newlines_, scan::Scanner());
+                pos_ = std::exchange(other.pos_, 0);
+            }
+            return *this;
+        }
+        inline ~Input() {
+            release();
+        }
+
+        static inline std::optional<Input> from_fd(int fd, std::string_view name = "<stdin>") {
+            struct stat st{};
+            if (::fstat(fd, &st) < 0) {
+                fmt::print(std::cerr, "Failed to stat '{}': {}\n", name, std::strerror(errno));
+                return std::nullopt;
+            }
+
+            Input ret{};
+            if (S_ISREG(st.st_mode) && st.st_size > 0) {
+                auto size = size_t(st.st_size);
+                auto addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+                if (addr != MAP_FAILED) {
+                    ::madvise(addr, size, MADV_SEQUENTIAL | MADV_WILLNEED);
+                    ret.mapping_ = addr;
+                    ret.mapping_size_ = size;
+                    ret.set_data(std::string_view(static_cast<const char*>(addr), size));
+                    return ret;
+                }
+            }
+
+            size_t capacity = S_ISREG(st.st_mode) ? size_t(st.st_size) + 1 : size_t(64 * 1024);
+            size_t size{0};
+            auto buffer = std::make_unique_for_overwrite<char[]>(capacity);
+            while (true) {
+                if (size == capacity) {
+                    auto tmp = std::make_unique_for_overwrite<char[]>(capacity * 2);
+                    std::memcpy(tmp.get(), buffer.get(), size);
+                    buffer = std::move(tmp);
+                    capacity *= 2;
+                }
+                auto rc = ::read(fd, buffer.get() + size, capacity - size);
+                if (rc < 0) {
+                    if (errno == EINTR) continue;
+                    fmt::print(std::cerr, "Failed to read '{}': {}\n", name, std::strerror(errno));
+                    return std::nullopt;
+                }
+                if (rc == 0) break;
+                size += size_t(rc);
+            }
+            ret.buffer_ = std::move(buffer);
+            ret.set_data(std::string_view(ret.buffer_.get(), size));
+            return ret;
+        }
+
+        static inline std::optional<Input> from_file(const char* path) {
+            int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                fmt::print(std::cerr, "Failed to open '{}': {}\n", path, std::strerror(errno));
+                return std::nullopt;
+            }
+            auto ret = from_fd(fd, path);
+            ::close(fd);
+            return ret;
+        }
+
+        static inline std::optional<Input> from_stdin() {
+            return from_fd(STDIN_FILENO);
+        }
+
+        static inline std::optional<Input> open(const Params& params) {
+            if (!params.positional().empty()) return from_file(params.positional().front().c_str());
+            return from_stdin();
+        }
+
+        inline std::string_view data() const noexcept { return data_; }
+        inline std::string_view remaining() const noexcept { return substr(data_, pos_); }
+        inline size_t size() const noexcept { return data_.size(); }
+        inline bool eof() const noexcept { return pos_ >= data_.size(); }
+        inline void rewind() noexcept { pos_ = 0; }
+
+        // 1-based line number of a position inside data(), for error messages.
+        inline size_t line_of(const char* p) const noexcept {
+            return size_t(std::count(data_.data(), p, '\n')) + 1;
+        }
+
+        // Same contract as std::getline(): the trailing '\n' is consumed but not
+        // returned and `line` is left untouched once the input is exhausted.
+        inline bool getline(std::string_view& line) noexcept {
+            if (pos_ >= data_.size()) return false;
+            auto end = newlines_.next(pos_);
+            line = std::string_view(data_.data() + pos_, end - pos_);
+            pos_ = end + 1;
+            return true;
+        }
+
+        // A record is a run of non-blank lines; records are separated by one or
+        // more blank lines. The returned view does not include the final '\n'.
+        inline bool next_record(std::string_view& record) noexcept {
+            std::string_view line{};
+            while (getline(line)) {
+                if (!trim(line).empty()) break;
+            }
+            if (trim(line).empty()) return false;
+            auto start = line.data();
+            auto end = line.data() + line.size();
+            while (getline(line)) {
+                if (trim(line).empty()) break;
+                end = line.data() + line.size();
+            }
+            record = std::string_view(start, end - start);
+            return true;
+        }
+
+    private:
+        std::unique_ptr<char[]> buffer_{};
+        void* mapping_{nullptr};
+        size_t mapping_size_{0};
+        std::string_view data_{};
+        scan::Scanner newlines_{};
+        size_t pos_{0};
+
+        inline void set_data(std::string_view data) noexcept {
+            data_ = data;
+            newlines_ = scan::Scanner(data, '\n');
+            pos_ = 0;
+        }
+
+        inline void release() noexcept {
+            if (mapping_) ::munmap(mapping_, mapping_size_);
+            mapping_ = nullptr;
+            mapping_size_ = 0;
+            buffer_.reset();
+        }
+    };
 }
 
 namespace aoc::detail::defer {
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+namespace aoc {
+    namespace detail {
+        // Base-from-member so the inline buffer exists before the resource
+        // that hands it out is constructed.
+        template <size_t Bytes>
+        struct ArenaStorage {
+            alignas(std::max_align_t) std::array<std::byte, Bytes> storage_;
+        };
+    }
+
+    // Monotonic arena for phases that allocate lots of short-lived objects:
+    // allocation is a pointer bump, deallocation is a no-op and release() (or
+    // the destructor) drops everything in one go. The first `InlineBytes` live
+    // inside the object itself, so a local arena serves small phases straight
+    // from the stack; further blocks come from `upstream` in growing sizes.
+    //
+    // Containers opt in through their std::pmr alias:
+    //
+    //   aoc::Arena arena{};
+    //   std::pmr::vector<Position> next(&arena);
+    //
+    // Everything allocated from an arena must be destroyed (or at least never
+    // touched again) before the arena is released.
+    template <size_t InlineBytes>
+    class BasicArena : private detail::ArenaStorage<InlineBytes>, public std::pmr::monotonic_buffer_resource {
+    public:
+        inline BasicArena() noexcept
+            : BasicArena(std::pmr::new_delete_resource())
+        {}
+        inline explicit BasicArena(std::pmr::memory_resource* upstream) noexcept
+            : monotonic_buffer_resource(this->storage_.data(), this->storage_.size(), upstream)
+        {}
+        inline BasicArena(const BasicArena&) = delete;
+        inline BasicArena& operator=(const BasicArena&) = delete;
+    };
+
+    using Arena = BasicArena<4096>;
+}
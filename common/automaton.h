@@ -0,0 +1,459 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <initializer_list>
+#include <numeric>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace aoc::ca {
+    template <size_t D>
+    using Offset = std::array<int, D>;
+
+    static constexpr const size_t max_neighbours = 127;
+
+    // Outer-totalistic rule: birth[n] (survive[n]) means that a dead (live)
+    // cell with n live neighbours is alive in the next generation.
+    struct Rule {
+        std::array<bool, max_neighbours + 1> birth{};
+        std::array<bool, max_neighbours + 1> survive{};
+    };
+
+    inline constexpr Rule rule(std::initializer_list<size_t> birth, std::initializer_list<size_t> survive) {
+        Rule ret{};
+        for (auto n : birth) ret.birth[n] = true;
+        for (auto n : survive) ret.survive[n] = true;
+        return ret;
+    }
+
+    inline constexpr size_t pow3(size_t n) {
+        return n ? 3 * pow3(n - 1) : 1;
+    }
+
+    // The 3^D - 1 cells at Chebyshev distance 1.
+    template <size_t D>
+    inline constexpr std::array<Offset<D>, pow3(D) - 1> moore() {
+        std::array<Offset<D>, pow3(D) - 1> ret{};
+        size_t n{0};
+        for (size_t i = 0; i < pow3(D); i++) {
+            Offset<D> off{};
+            bool self{true};
+            for (size_t d = 0, v = i; d < D; d++, v /= 3) {
+                off[d] = int(v % 3) - 1;
+                self = self && !off[d];
+            }
+            if (!self) ret[n++] = off;
+        }
+        return ret;
+    }
+
+    // Hexagonal tiling in axial coordinates (q, r).
+    inline constexpr std::array<Offset<2>, 6> hex_axial() {
+        return {{{1, 0}, {-1, 0}, {0, -1}, {1, -1}, {-1, 1}, {0, 1}}};
+    }
+
+    // Column-wise population count of a set of words, as bit-sliced planes.
+    // A carry-save adder tree folds three words of one weight into one of
+    // that weight and one of the next. The number of adders only depends on
+    // the number of inputs, so the loops are branch free in practice.
+    // `Capacity` bounds the words queued per plane, including partial sums:
+    // twice the number of inputs of the busiest plane is always enough.
+    template <size_t Planes, size_t Capacity>
+    class PlaneSum {
+    public:
+        inline void add(uint64_t bits, size_t plane) noexcept {
+            words_[plane][count_[plane]++] = bits;
+        }
+
+        inline std::array<uint64_t, Planes> reduce() noexcept {
+            std::array<uint64_t, Planes> ret{};
+            for (size_t p = 0; p < Planes; p++) {
+                auto* w = words_[p].data();
+                size_t i{0}, n{count_[p]};
+                for (; n - i >= 3; i += 3) {
+                    auto a = w[i], b = w[i + 1], c = w[i + 2];
+                    w[n++] = a ^ b ^ c;
+                    carry(p, (a & b) | (a & c) | (b & c));
+                }
+                if (n - i == 2) {
+                    ret[p] = w[i] ^ w[i + 1];
+                    carry(p, w[i] & w[i + 1]);
+                } else if (n - i == 1) {
+                    ret[p] = w[i];
+                }
+            }
+            return ret;
+        }
+
+    private:
+        std::array<std::array<uint64_t, Capacity>, Planes> words_;
+        std::array<size_t, Planes> count_{};
+
+        inline void carry(size_t plane, uint64_t bits) noexcept {
+            if (plane + 1 < Planes) add(bits, plane + 1);
+        }
+    };
+
+    // Bit-packed D dimensional grid. Axis 0 runs along the bits of a row of
+    // 64-bit words; every other combination of coordinates is one row. The
+    // grid is surrounded by `pad` rows of dead cells on each side of every
+    // other axis and by one dead word at both ends of each row, so reads up
+    // to that far outside the extents need no bounds checks.
+    template <size_t D>
+    class BitGrid {
+        static_assert(D >= 2);
+
+    public:
+        using Coords = std::array<size_t, D>;
+        using SignedCoords = std::array<ptrdiff_t, D>;
+
+        inline BitGrid() = default;
+        inline BitGrid(const Coords& extents, const Coords& pad) : extents_(extents), pad_(pad) {
+            words_ = (extents[0] + 63) / 64;
+            size_t size = words_ + 2;
+            for (size_t d = 1; d < D; d++) {
+                strides_[d] = size;
+                size *= extents[d] + 2 * pad[d];
+            }
+            data_.assign(size, 0);
+        }
+
+        inline const Coords& extents() const noexcept { return extents_; }
+        inline size_t words() const noexcept { return words_; }
+
+        // First real word of the row at `c` (c[0] is ignored). Coordinates
+        // may lie up to the padding outside the extents.
+        inline uint64_t* row(const SignedCoords& c) noexcept { return data_.data() + offset(c); }
+        inline const uint64_t* row(const SignedCoords& c) const noexcept { return data_.data() + offset(c); }
+
+        inline bool get(const Coords& c) const noexcept {
+            return (row(signed_coords(c))[c[0] / 64] >> (c[0] % 64)) & 1;
+        }
+
+        inline void set(const Coords& c, bool value = true) noexcept {
+            auto& w = row(signed_coords(c))[c[0] / 64];
+            auto bit = uint64_t(1) << (c[0] % 64);
+            w = value ? w | bit : w & ~bit;
+        }
+
+        inline size_t population() const noexcept {
+            return std::accumulate(data_.begin(), data_.end(), size_t(0), [](size_t acc, uint64_t w) -> size_t {
+                return acc + size_t(std::popcount(w));
+            });
+        }
+
+        inline void swap(BitGrid& other) noexcept {
+            std::swap(extents_, other.extents_);
+            std::swap(pad_, other.pad_);
+            std::swap(strides_, other.strides_);
+            std::swap(words_, other.words_);
+            data_.swap(other.data_);
+        }
+
+        static inline SignedCoords signed_coords(const Coords& c) noexcept {
+            SignedCoords ret{};
+            for (size_t d = 0; d < D; d++) ret[d] = ptrdiff_t(c[d]);
+            return ret;
+        }
+
+    private:
+        Coords extents_{};
+        Coords pad_{};
+        Coords strides_{};
+        size_t words_{0};
+        std::vector<uint64_t> data_{};
+
+        inline size_t offset(const SignedCoords& c) const noexcept {
+            size_t ret{1};
+            for (size_t d = 1; d < D; d++) ret += size_t(c[d] + ptrdiff_t(pad_[d])) * strides_[d];
+            return ret;
+        }
+    };
+}
+
+namespace aoc {
+    // Double-buffered cellular automaton on a finite D dimensional grid.
+    //
+    //   using Life = aoc::CellularAutomaton<2, aoc::ca::moore<2>(), aoc::ca::rule({3}, {2, 3})>;
+    //   Life life({width, height}, &pool);
+    //   life.set({x, y});
+    //   life.run(100);
+    //
+    // `Offsets` is the neighbourhood. An offset along axis 0 can be at most
+    // 63; the other axes are only limited by memory, since the grid is padded
+    // by the largest offset along each of them. Cells outside the extents are
+    // permanently dead. mask() restricts the board to a set of cells, and no
+    // other cell is ever alive.
+    //
+    // Cells are bits. A generation sums, for every word of 64 cells, the
+    // neighbour words (shifted along axis 0) with a carry-save adder tree and
+    // applies the rule to the bit-sliced counts. Only the bounding box of the
+    // live cells, grown by the neighbourhood, is visited. Rules that give
+    // birth at zero neighbours have no such bound and visit the whole board.
+    //
+    // With a thread pool each generation is split into tiles, which are slabs
+    // along the last axis, and the tiles are stepped concurrently. Tiles read
+    // their halo (the rows of neighbouring tiles within reach) straight from
+    // the previous generation's buffer, which nobody writes during the step,
+    // so there is nothing to exchange. Every tile writes only its own rows.
+    template <size_t D, auto Offsets, ca::Rule R, typename Storage = ca::BitGrid<D>>
+    class CellularAutomaton {
+    public:
+        using Coords = std::array<size_t, D>;
+
+    private:
+        using SignedCoords = std::array<ptrdiff_t, D>;
+
+        static constexpr const size_t neighbours = Offsets.size();
+        static constexpr const size_t planes = size_t(std::bit_width(neighbours));
+        static constexpr const bool spontaneous = R.birth[0];
+
+        static constexpr Coords compute_reach() {
+            Coords ret{};
+            for (const auto& off : Offsets)
+                for (size_t d = 0; d < D; d++)
+                    ret[d] = std::max(ret[d], size_t(off[d] < 0 ? -off[d] : off[d]));
+            return ret;
+        }
+        static constexpr const Coords reach = compute_reach();
+        static_assert(reach[0] < 64, "offsets along axis 0 must stay within a neighbouring word");
+        static_assert(neighbours <= ca::max_neighbours);
+
+        // Bounding box of the live cells: rows along axes 1.., words along 0.
+        struct Box {
+            SignedCoords lo{};
+            SignedCoords hi{};
+            bool empty{true};
+
+            inline void add(const SignedCoords& c, ptrdiff_t word) noexcept {
+                if (empty) {
+                    lo = hi = c;
+                    lo[0] = hi[0] = word;
+                    empty = false;
+                    return;
+                }
+                for (size_t d = 1; d < D; d++) {
+                    lo[d] = std::min(lo[d], c[d]);
+                    hi[d] = std::max(hi[d], c[d]);
+                }
+                lo[0] = std::min(lo[0], word);
+                hi[0] = std::max(hi[0], word);
+            }
+
+            inline void merge(const Box& other) noexcept {
+                if (other.empty) return;
+                add(other.lo, other.lo[0]);
+                add(other.hi, other.hi[0]);
+            }
+        };
+
+    public:
+        inline explicit CellularAutomaton(const Coords& extents, ThreadPool* pool = nullptr)
+            : current_(extents, reach), next_(extents, reach), pool_(pool)
+        {}
+
+        inline const Coords& extents() const noexcept { return current_.extents(); }
+
+        inline bool get(const Coords& c) const noexcept { return current_.get(c); }
+
+        inline void set(const Coords& c, bool alive = true) noexcept {
+            current_.set(c, alive);
+            box_valid_ = false;
+        }
+
+        inline void mask(const Coords& c) {
+            if (!masked_) {
+                mask_ = Storage(extents(), reach);
+                masked_ = true;
+            }
+            mask_.set(c);
+        }
+
+        inline size_t population() const noexcept { return current_.population(); }
+
+        // Advances one generation; returns whether any cell changed.
+        inline bool step() {
+            if (!box_valid_) {
+                box_ = scan();
+                box_valid_ = true;
+            }
+            if (box_.empty && !spontaneous) return false;
+
+            auto region = visit_region();
+
+            // next_ still holds the generation before current_, whose live
+            // cells all lie in prev_box_; that is all there is to clear.
+            clear(next_, prev_box_);
+
+            auto lo = region.lo[D - 1], hi = region.hi[D - 1];
+            auto tiles = pool_ ? std::min<size_t>(pool_->size(), size_t(hi - lo + 1)) : 1;
+            Box box{};
+            bool changed{false};
+            if (tiles <= 1) {
+                changed = step_tile(region, box);
+            } else {
+                std::vector<std::future<std::pair<bool, Box>>> jobs{};
+                jobs.reserve(tiles);
+                auto rows = hi - lo + 1;
+                for (size_t t = 0; t < tiles; t++) {
+                    auto tile = region;
+                    tile.lo[D - 1] = lo + ptrdiff_t(t * size_t(rows) / tiles);
+                    tile.hi[D - 1] = lo + ptrdiff_t((t + 1) * size_t(rows) / tiles) - 1;
+                    jobs.push_back(pool_->submit([this, tile]() -> std::pair<bool, Box> {
+                        Box box{};
+                        bool changed = step_tile(tile, box);
+                        return {changed, box};
+                    }));
+                }
+                for (auto& job : jobs) {
+                    auto [tile_changed, tile_box] = job.get();
+                    changed |= tile_changed;
+                    box.merge(tile_box);
+                }
+            }
+
+            current_.swap(next_);
+            prev_box_ = box_;
+            box_ = box;
+            return changed;
+        }
+
+        // Runs up to `generations` steps, stopping early once a generation
+        // changes nothing; returns the number of steps taken.
+        inline size_t run(size_t generations) {
+            for (size_t g = 0; g < generations; g++)
+                if (!step()) return g + 1;
+            return generations;
+        }
+
+        inline size_t run_until_stable() {
+            size_t ret{1};
+            while (step()) ret++;
+            return ret;
+        }
+
+    private:
+        Storage current_;
+        Storage next_;
+        Storage mask_{};
+        bool masked_{false};
+        ThreadPool* pool_;
+        Box box_{};
+        Box prev_box_{};
+        bool box_valid_{false};
+
+        inline ptrdiff_t extent(size_t d) const noexcept {
+            return ptrdiff_t(d ? current_.extents()[d] : current_.words());
+        }
+
+        inline Box whole_grid() const noexcept {
+            Box ret{};
+            ret.empty = false;
+            for (size_t d = 0; d < D; d++) ret.hi[d] = extent(d) - 1;
+            return ret;
+        }
+
+        // Live box grown by the neighbourhood and clamped to the grid.
+        inline Box visit_region() const noexcept {
+            if (spontaneous) return whole_grid();
+            Box ret{};
+            ret.empty = false;
+            for (size_t d = 0; d < D; d++) {
+                auto grow = ptrdiff_t(d ? reach[d] : 1);
+                ret.lo[d] = std::max(box_.lo[d] - grow, ptrdiff_t(0));
+                ret.hi[d] = std::min(box_.hi[d] + grow, extent(d) - 1);
+            }
+            return ret;
+        }
+
+        template <typename Callable>
+        static inline void for_each_row(const Box& box, Callable f) {
+            if (box.empty) return;
+            SignedCoords c = box.lo;
+            while (true) {
+                f(c);
+                size_t d = 1;
+                for (; d < D; d++) {
+                    if (c[d] < box.hi[d]) {
+                        c[d]++;
+                        break;
+                    }
+                    c[d] = box.lo[d];
+                }
+                if (d == D) return;
+            }
+        }
+
+        inline void clear(Storage& grid, const Box& box) const noexcept {
+            for_each_row(box, [&grid, &box](const SignedCoords& c) {
+                std::fill(grid.row(c) + box.lo[0], grid.row(c) + box.hi[0] + 1, 0);
+            });
+        }
+
+        inline Box scan() const noexcept {
+            Box ret{};
+            for_each_row(whole_grid(), [this, &ret](const SignedCoords& c) {
+                const auto* row = current_.row(c);
+                for (size_t k = 0; k < current_.words(); k++)
+                    if (row[k]) ret.add(c, ptrdiff_t(k));
+            });
+            return ret;
+        }
+
+        static inline uint64_t shifted(const uint64_t* row, ptrdiff_t k, int s) noexcept {
+            if (s > 0) return (row[k] >> s) | (row[k + 1] << (64 - s));
+            if (s < 0) return (row[k] << -s) | (row[k - 1] >> (64 + s));
+            return row[k];
+        }
+
+        static inline uint64_t count_is(const std::array<uint64_t, planes>& counts, size_t n) noexcept {
+            uint64_t ret{~uint64_t(0)};
+            for (size_t p = 0; p < planes; p++) ret &= (n >> p) & 1 ? counts[p] : ~counts[p];
+            return ret;
+        }
+
+        inline bool step_tile(const Box& region, Box& box) noexcept {
+            bool changed{false};
+            auto tail_bits = current_.extents()[0] % 64;
+            auto last_word = ptrdiff_t(current_.words()) - 1;
+            std::array<const uint64_t*, neighbours> sources{};
+
+            for_each_row(region, [&](const SignedCoords& c) {
+                for (size_t i = 0; i < neighbours; i++) {
+                    auto sc = c;
+                    for (size_t d = 1; d < D; d++) sc[d] += Offsets[i][d];
+                    sources[i] = current_.row(sc);
+                }
+                const auto* self = current_.row(c);
+                const auto* allowed = masked_ ? mask_.row(c) : nullptr;
+                auto* dst = next_.row(c);
+
+                for (auto k = region.lo[0]; k <= region.hi[0]; k++) {
+                    ca::PlaneSum<planes, 2 * neighbours + 2> sum;
+                    for (size_t i = 0; i < neighbours; i++) sum.add(shifted(sources[i], k, Offsets[i][0]), 0);
+                    auto counts = sum.reduce();
+
+                    auto cur = self[k];
+                    uint64_t next{0};
+                    for (size_t n = 0; n <= neighbours; n++) {
+                        if (R.birth[n]) next |= ~cur & count_is(counts, n);
+                        if (R.survive[n]) next |= cur & count_is(counts, n);
+                    }
+                    if (k == last_word && tail_bits) next &= (uint64_t(1) << tail_bits) - 1;
+                    if (allowed) next &= allowed[k];
+
+                    dst[k] = next;
+                    changed |= next != cur;
+                    if (next) box.add(c, k);
+                }
+            });
+            return changed;
+        }
+    };
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace aoc {
+    // Unsigned arbitrary precision integer; just enough arithmetic for
+    // results that outgrow 128 bits (sums, products and remainders by
+    // machine words). Limbs are little endian with no leading zero limbs,
+    // so zero has no limbs at all.
+    class BigUint {
+    public:
+        inline BigUint() = default;
+        inline BigUint(unsigned __int128 v) {
+            while (v) {
+                limbs_.push_back(uint64_t(v));
+                v >>= 64;
+            }
+        }
+
+        inline bool is_zero() const noexcept { return limbs_.empty(); }
+
+        inline size_t bit_width() const noexcept {
+            if (limbs_.empty()) return 0;
+            return (limbs_.size() - 1) * 64 + size_t(std::bit_width(limbs_.back()));
+        }
+
+        inline BigUint& operator+=(const BigUint& other) {
+            if (limbs_.size() < other.limbs_.size()) limbs_.resize(other.limbs_.size(), 0);
+            uint64_t carry{0};
+            for (size_t i = 0; i < limbs_.size(); i++) {
+                auto sum = static_cast<unsigned __int128>(limbs_[i]) + carry;
+                if (i < other.limbs_.size()) sum += other.limbs_[i];
+                limbs_[i] = uint64_t(sum);
+                carry = uint64_t(sum >> 64);
+            }
+            if (carry) limbs_.push_back(carry);
+            return *this;
+        }
+
+        inline BigUint& operator*=(uint64_t m) {
+            if (!m) {
+                limbs_.clear();
+                return *this;
+            }
+            uint64_t carry{0};
+            for (auto& limb : limbs_) {
+                auto prod = static_cast<unsigned __int128>(limb) * m + carry;
+                limb = uint64_t(prod);
+                carry = uint64_t(prod >> 64);
+            }
+            if (carry) limbs_.push_back(carry);
+            return *this;
+        }
+
+        inline friend BigUint operator+(BigUint a, const BigUint& b) { return a += b; }
+        inline friend BigUint operator*(BigUint a, uint64_t m) { return a *= m; }
+
+        // Divides in place by `d` (non-zero) and returns the remainder.
+        inline uint64_t divmod(uint64_t d) noexcept {
+            unsigned __int128 rem{0};
+            for (size_t i = limbs_.size(); i-- > 0;) {
+                auto cur = (rem << 64) | limbs_[i];
+                limbs_[i] = uint64_t(cur / d);
+                rem = cur % d;
+            }
+            trim();
+            return uint64_t(rem);
+        }
+
+        inline uint64_t operator%(uint64_t d) const noexcept {
+            unsigned __int128 rem{0};
+            for (size_t i = limbs_.size(); i-- > 0;)
+                rem = ((rem << 64) | limbs_[i]) % d;
+            return uint64_t(rem);
+        }
+
+        inline std::strong_ordering operator<=>(const BigUint& other) const noexcept {
+            if (limbs_.size() != other.limbs_.size()) return limbs_.size() <=> other.limbs_.size();
+            return std::lexicographical_compare_three_way(limbs_.rbegin(), limbs_.rend(),
+                other.limbs_.rbegin(), other.limbs_.rend());
+        }
+        inline bool operator==(const BigUint& other) const noexcept = default;
+
+        inline std::string to_string() const {
+            if (limbs_.empty()) return "0";
+            // Peel off 19 decimal digits at a time, least significant first.
+            static constexpr const uint64_t chunk = 10000000000000000000ull;
+            auto tmp = *this;
+            std::vector<uint64_t> chunks{};
+            while (!tmp.is_zero()) chunks.push_back(tmp.divmod(chunk));
+            auto ret = fmt::format("{}", chunks.back());
+            for (size_t i = chunks.size() - 1; i-- > 0;) ret += fmt::format("{:019}", chunks[i]);
+            return ret;
+        }
+
+    private:
+        std::vector<uint64_t> limbs_{};
+
+        inline void trim() noexcept {
+            while (!limbs_.empty() && !limbs_.back()) limbs_.pop_back();
+        }
+    };
+}
+
+namespace fmt {
+    template <>
+    struct formatter<aoc::BigUint> : formatter<std::string> {
+        template <typename FormatContext>
+        auto format(const aoc::BigUint& v, FormatContext &ctx) {
+            return formatter<std::string>::format(v.to_string(), ctx);
+        }
+    };
+}
@@ -0,0 +1,25 @@
+#include <aoc.h>
+#include <days.h>
+
+#if !defined(AOC_DAY)
+#error "AOC_DAY must be defined to the number of the day being built"
+#endif
+
+int main(int argc, char* argv[]) {
+    auto params = aoc::Params(argc, argv);
+    auto input = aoc::Input::open(params);
+    if (!input) return 1;
+
+    auto answer = AOC_DAY_SOLVER(input->data(), params);
+    if (!answer) return 1;
+
+    if constexpr (aoc::profile::enabled) {
+        if (answer->part1) aoc::profile::record(fmt::format("day{} part 1", AOC_DAY), answer->part1_time());
+        if (answer->part2) aoc::profile::record(fmt::format("day{} part 2", AOC_DAY), answer->part2_time());
+    }
+
+    if (answer->part1) fmt::print("{}\n", answer->part1.value());
+    if (answer->part2) fmt::print("{}\n", answer->part2.value());
+
+    return 0;
+}
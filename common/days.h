@@ -0,0 +1,64 @@
+#pragma once
+
+#include "aoc.h"
+
+// Every day lives in its own `dayN` namespace and exposes the same entry point.
+// The per-day executables (common/day_main.cpp), aoc_bench and aoc_all all go
+// through it.
+#define AOC_FOR_EACH_DAY(X) \
+    X(1)  X(2)  X(3)  X(4)  X(5)  X(6)  X(7)  X(8)  X(9)  X(10) \
+    X(11) X(12) X(13) X(14) X(15) X(16) X(17) X(18) X(19) X(20) \
+    X(21) X(22) X(23) X(24) X(25)
+
+#define AOC_DECLARE_SOLVER(num) _AOC_DECLARE_SOLVER(num)
+#define _AOC_DECLARE_SOLVER(num) \
+    namespace day ## num { \
+        std::optional<aoc::Answer> solve(std::string_view input, const aoc::Params& params); \
+    }
+
+namespace aoc {
+    using Solver = std::optional<Answer> (*)(std::string_view input, const Params& params);
+
+    struct Day {
+        unsigned number;
+        Solver solve;
+    };
+}
+
+#if defined(AOC_DAY)
+#define _aoc_day_cathack_2(a, b) a ## b
+#define _aoc_day_cathack_1(a, b) _aoc_day_cathack_2(a, b)
+#define AOC_DAY_SOLVER _aoc_day_cathack_1(day, AOC_DAY)::solve
+
+AOC_DECLARE_SOLVER(AOC_DAY)
+#else
+AOC_FOR_EACH_DAY(AOC_DECLARE_SOLVER)
+
+namespace aoc {
+    inline const std::vector<Day>& all_days() {
+#define _AOC_DAY_ENTRY(num) Day{num, &day ## num::solve},
+        static const std::vector<Day> days{ AOC_FOR_EACH_DAY(_AOC_DAY_ENTRY) };
+#undef _AOC_DAY_ENTRY
+        return days;
+    }
+
+    // The days named by the positional arguments, or all of them if none are.
+    inline std::optional<std::vector<Day>> select_days(const Params& params) {
+        if (params.positional().empty()) return all_days();
+
+        std::set<unsigned> selected{};
+        for (const auto& arg : params.positional()) {
+            unsigned n{0};
+            if (!from_chars(arg, n) || n < 1 || n > all_days().size()) {
+                fmt::print(std::cerr, "Invalid day: '{}'\n", arg);
+                return std::nullopt;
+            }
+            selected.insert(n);
+        }
+
+        std::vector<Day> ret{};
+        for (auto n : selected) ret.push_back(all_days().at(n - 1));
+        return ret;
+    }
+}
+#endif
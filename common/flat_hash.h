@@ -0,0 +1,639 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <fmt/format.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace aoc {
+    namespace detail::hashing {
+        // 64x64 -> 128 bit multiply folded back to 64 bits; the core of most
+        // modern non-cryptographic hashes (wyhash, rapidhash, ...).
+        inline constexpr uint64_t mum(uint64_t a, uint64_t b) noexcept {
+            auto r = static_cast<unsigned __int128>(a) * b;
+            return uint64_t(r) ^ uint64_t(r >> 64);
+        }
+
+        inline constexpr uint64_t mix(uint64_t v) noexcept {
+            return mum(v ^ 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull);
+        }
+
+        inline uint64_t read8(const char* p) noexcept {
+            uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline uint64_t read4(const char* p) noexcept {
+            uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline uint64_t bytes(const char* p, size_t n, uint64_t seed = 0) noexcept {
+            constexpr uint64_t k0 = 0xa0761d6478bd642full;
+            constexpr uint64_t k1 = 0xe7037ed1a0b428dbull;
+            uint64_t a{0}, b{0};
+            seed ^= mum(seed ^ k0, k1) ^ n;
+            if (n <= 16) {
+                if (n >= 4) {
+                    a = (read4(p) << 32) | read4(p + ((n >> 3) << 2));
+                    b = (read4(p + n - 4) << 32) | read4(p + n - 4 - ((n >> 3) << 2));
+                } else if (n > 0) {
+                    a = (uint64_t(uint8_t(p[0])) << 16) | (uint64_t(uint8_t(p[n >> 1])) << 8) | uint8_t(p[n - 1]);
+                }
+            } else {
+                size_t i = n;
+                while (i > 16) {
+                    seed = mum(read8(p) ^ k1, read8(p + 8) ^ seed);
+                    p += 16;
+                    i -= 16;
+                }
+                a = read8(p + i - 16);
+                b = read8(p + i - 8);
+            }
+            return mum(k1 ^ n, mum(a ^ k1, b ^ seed));
+        }
+    }
+
+    // Default hasher of the flat containers. Integers, enums and pointers go
+    // through a multiply-fold mixer (so sequential keys spread over the whole
+    // table), anything string-like is hashed as bytes and every other type
+    // falls back to std::hash, mixed the same way.
+    template <typename T>
+    struct Hash {
+        inline size_t operator()(const T& v) const noexcept {
+            if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+                return detail::hashing::mix(uint64_t(v));
+            } else if constexpr (std::is_pointer_v<T>) {
+                return detail::hashing::mix(uint64_t(reinterpret_cast<uintptr_t>(v)));
+            } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                auto sv = std::string_view(v);
+                return detail::hashing::bytes(sv.data(), sv.size());
+            } else {
+                return detail::hashing::mix(uint64_t(std::hash<T>{}(v)));
+            }
+        }
+    };
+
+    namespace detail::flat {
+        using ctrl_t = int8_t;
+
+        // Control byte of every slot: empty, deleted (tombstone) or, for a
+        // full slot, the low 7 bits of the key's hash.
+        static constexpr const ctrl_t ctrl_empty = -128;
+        static constexpr const ctrl_t ctrl_deleted = -2;
+        static constexpr const size_t group_size = 16;
+
+        // Sixteen control bytes probed at once. Every match_*() returns a bit
+        // mask with bit `i` set for the slots of interest.
+        class Group {
+        public:
+            inline explicit Group(const ctrl_t* p) noexcept
+#if defined(__SSE2__)
+                : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)))
+#else
+                : ctrl_(p)
+#endif
+            {}
+
+            inline uint32_t match(ctrl_t h2) const noexcept {
+#if defined(__SSE2__)
+                return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_, _mm_set1_epi8(h2))));
+#else
+                return scalar([h2](ctrl_t c) { return c == h2; });
+#endif
+            }
+
+            inline uint32_t match_empty() const noexcept {
+                return match(ctrl_empty);
+            }
+
+            inline uint32_t match_empty_or_deleted() const noexcept {
+#if defined(__SSE2__)
+                return uint32_t(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl_)));
+#else
+                return scalar([](ctrl_t c) { return c < -1; });
+#endif
+            }
+
+        private:
+#if defined(__SSE2__)
+            __m128i ctrl_;
+#else
+            const ctrl_t* ctrl_;
+
+            template <typename Pred>
+            inline uint32_t scalar(Pred pred) const noexcept {
+                uint32_t ret{0};
+                for (size_t i = 0; i < group_size; i++)
+                    ret |= uint32_t(pred(ctrl_[i])) << i;
+                return ret;
+            }
+#endif
+        };
+
+        // Control bytes of a table without storage: one group that is always
+        // empty, so lookups need no special case.
+        alignas(group_size) inline constexpr const ctrl_t empty_group[group_size] = {
+            ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+            ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+        };
+
+        struct SetPolicy {
+            template <typename Slot>
+            static inline const auto& key(const Slot& s) noexcept { return s; }
+        };
+
+        struct MapPolicy {
+            template <typename Slot>
+            static inline const auto& key(const Slot& s) noexcept { return s.first; }
+        };
+
+        // Swiss-table style open addressing. Slots live in one flat array with
+        // a parallel array of control bytes; lookups probe a whole group of
+        // control bytes with one SIMD compare and only touch slots whose 7-bit
+        // hash tag matches. The table grows at 7/8 load.
+        template <typename Key, typename Slot, typename Policy, typename HashT, typename Eq, typename Alloc>
+        class Table {
+            using slot_alloc_t = typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+            using slot_traits = std::allocator_traits<slot_alloc_t>;
+            using ctrl_alloc_t = typename std::allocator_traits<Alloc>::template rebind_alloc<ctrl_t>;
+            using ctrl_traits = std::allocator_traits<ctrl_alloc_t>;
+
+            static constexpr const size_t npos = ~size_t(0);
+
+        public:
+            using key_type = Key;
+            using value_type = Slot;
+            using size_type = size_t;
+            using hasher = HashT;
+            using key_equal = Eq;
+            using allocator_type = Alloc;
+
+            template <bool Const>
+            class Iterator {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = Slot;
+                using difference_type = std::ptrdiff_t;
+                using pointer = std::conditional_t<Const, const Slot*, Slot*>;
+                using reference = std::conditional_t<Const, const Slot&, Slot&>;
+
+                inline Iterator() = default;
+                inline Iterator(const ctrl_t* ctrl, const ctrl_t* end, pointer slot) noexcept
+                    : ctrl_(ctrl), end_(end), slot_(slot)
+                {
+                    skip();
+                }
+                template <bool C = Const, typename = std::enable_if_t<C>>
+                inline Iterator(const Iterator<false>& other) noexcept
+                    : ctrl_(other.ctrl_), end_(other.end_), slot_(other.slot_)
+                {}
+
+                inline reference operator*() const noexcept { return *slot_; }
+                inline pointer operator->() const noexcept { return slot_; }
+                inline Iterator& operator++() noexcept {
+                    ++ctrl_;
+                    ++slot_;
+                    skip();
+                    return *this;
+                }
+                inline Iterator operator++(int) noexcept {
+                    auto ret = *this;
+                    ++*this;
+                    return ret;
+                }
+                inline bool operator==(const Iterator& other) const noexcept { return ctrl_ == other.ctrl_; }
+
+            private:
+                template <typename, typename, typename, typename, typename, typename>
+                friend class Table;
+                template <bool>
+                friend class Iterator;
+
+                const ctrl_t* ctrl_{nullptr};
+                const ctrl_t* end_{nullptr};
+                pointer slot_{nullptr};
+
+                inline void skip() noexcept {
+                    while (ctrl_ != end_ && *ctrl_ < 0) {
+                        ++ctrl_;
+                        ++slot_;
+                    }
+                }
+            };
+
+            using iterator = Iterator<false>;
+            using const_iterator = Iterator<true>;
+
+            inline Table() = default;
+            inline explicit Table(const Alloc& alloc) : alloc_(alloc) {}
+            inline Table(size_t capacity, const Alloc& alloc = Alloc()) : alloc_(alloc) {
+                reserve(capacity);
+            }
+            template <typename It>
+            inline Table(It first, It last, const Alloc& alloc = Alloc()) : alloc_(alloc) {
+                insert(first, last);
+            }
+            inline Table(std::initializer_list<Slot> values, const Alloc& alloc = Alloc()) : alloc_(alloc) {
+                insert(values.begin(), values.end());
+            }
+            inline Table(const Table& other)
+                : alloc_(slot_traits::select_on_container_copy_construction(other.alloc_))
+            {
+                copy_from(other);
+            }
+            inline Table(Table&& other) noexcept
+                : alloc_(std::move(other.alloc_))
+            {
+                steal(other);
+            }
+            inline Table& operator=(const Table& other) {
+                if (this == &other) return *this;
+                destroy();
+                if constexpr (slot_traits::propagate_on_container_copy_assignment::value)
+                    alloc_ = other.alloc_;
+                copy_from(other);
+                return *this;
+            }
+            inline Table& operator=(Table&& other) noexcept(slot_traits::propagate_on_container_move_assignment::value || slot_traits::is_always_equal::value) {
+                if (this == &other) return *this;
+                destroy();
+                if constexpr (slot_traits::propagate_on_container_move_assignment::value) {
+                    alloc_ = std::move(other.alloc_);
+                    steal(other);
+                } else if (alloc_ == other.alloc_) {
+                    steal(other);
+                } else {
+                    reserve(other.size());
+                    for (auto& v : other) insert_unique(std::move(v));
+                    other.clear();
+                }
+                return *this;
+            }
+            inline ~Table() {
+                destroy();
+            }
+
+            inline allocator_type get_allocator() const noexcept { return allocator_type(alloc_); }
+
+            inline iterator begin() noexcept { return iterator(ctrl_, ctrl_ + capacity_, slots_); }
+            inline iterator end() noexcept { return iterator(ctrl_ + capacity_, ctrl_ + capacity_, slots_ + capacity_); }
+            inline const_iterator begin() const noexcept { return const_iterator(ctrl_, ctrl_ + capacity_, slots_); }
+            inline const_iterator end() const noexcept { return const_iterator(ctrl_ + capacity_, ctrl_ + capacity_, slots_ + capacity_); }
+            inline const_iterator cbegin() const noexcept { return begin(); }
+            inline const_iterator cend() const noexcept { return end(); }
+
+            inline size_t size() const noexcept { return size_; }
+            inline bool empty() const noexcept { return !size_; }
+            inline size_t capacity() const noexcept { return capacity_; }
+
+            inline void clear() noexcept {
+                if (!capacity_) return;
+                for_each_full([this](size_t i) { slot_traits::destroy(alloc_, slots_ + i); });
+                std::memset(ctrl_, ctrl_empty, capacity_);
+                size_ = 0;
+                growth_left_ = max_load(capacity_);
+            }
+
+            // Makes room for `count` elements without further rehashing.
+            inline void reserve(size_t count) {
+                if (count <= size_ + growth_left_) return;
+                rehash(capacity_for(count));
+            }
+
+            inline iterator find(const Key& key) noexcept {
+                auto idx = find_index(key);
+                return idx == npos ? end() : iterator_at(idx);
+            }
+            inline const_iterator find(const Key& key) const noexcept {
+                auto idx = find_index(key);
+                return idx == npos ? end() : const_iterator(ctrl_ + idx, ctrl_ + capacity_, slots_ + idx);
+            }
+            inline bool contains(const Key& key) const noexcept { return find_index(key) != npos; }
+            inline size_t count(const Key& key) const noexcept { return contains(key); }
+
+            inline std::pair<iterator, bool> insert(const Slot& value) {
+                return emplace_impl(Policy::key(value), value);
+            }
+            inline std::pair<iterator, bool> insert(Slot&& value) {
+                return emplace_impl(Policy::key(value), std::move(value));
+            }
+            template <typename It>
+            inline void insert(It first, It last) {
+                if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>)
+                    reserve(size_ + size_t(std::distance(first, last)));
+                for (; first != last; ++first) insert(*first);
+            }
+
+            // Tombstones the slot; iterators to other elements stay valid and
+            // iteration may continue from the returned iterator.
+            inline iterator erase(const_iterator pos) noexcept {
+                auto idx = size_t(pos.ctrl_ - ctrl_);
+                erase_at(idx);
+                return iterator(ctrl_ + idx + 1, ctrl_ + capacity_, slots_ + idx + 1);
+            }
+            inline iterator erase(iterator pos) noexcept {
+                return erase(const_iterator(pos));
+            }
+            inline size_t erase(const Key& key) noexcept {
+                auto idx = find_index(key);
+                if (idx == npos) return 0;
+                erase_at(idx);
+                return 1;
+            }
+
+            inline void swap(Table& other) noexcept {
+                if constexpr (slot_traits::propagate_on_container_swap::value) {
+                    using std::swap;
+                    swap(alloc_, other.alloc_);
+                }
+                std::swap(ctrl_, other.ctrl_);
+                std::swap(slots_, other.slots_);
+                std::swap(capacity_, other.capacity_);
+                std::swap(size_, other.size_);
+                std::swap(growth_left_, other.growth_left_);
+            }
+            friend inline void swap(Table& a, Table& b) noexcept { a.swap(b); }
+
+            friend inline bool operator==(const Table& a, const Table& b) {
+                if (a.size() != b.size()) return false;
+                for (const auto& v : a) {
+                    auto it = b.find(Policy::key(v));
+                    if (it == b.end() || !(*it == v)) return false;
+                }
+                return true;
+            }
+
+        protected:
+            template <typename K, typename... Args>
+            inline std::pair<iterator, bool> emplace_impl(const K& key, Args&&... args) {
+                auto hash = hasher{}(key);
+                if (auto idx = find_index(key, hash); idx != npos) return {iterator_at(idx), false};
+                auto idx = prepare_insert(hash);
+                slot_traits::construct(alloc_, slots_ + idx, std::forward<Args>(args)...);
+                return {iterator_at(idx), true};
+            }
+
+            inline iterator iterator_at(size_t idx) noexcept {
+                return iterator(ctrl_ + idx, ctrl_ + capacity_, slots_ + idx);
+            }
+
+            inline size_t find_index(const Key& key) const noexcept {
+                return find_index(key, hasher{}(key));
+            }
+
+            inline size_t find_index(const Key& key, size_t hash) const noexcept {
+                auto tag = h2(hash);
+                auto mask = group_mask();
+                auto g = h1(hash) & mask;
+                for (size_t step = 1; ; step++) {
+                    auto group = Group(ctrl_ + g * group_size);
+                    for (auto m = group.match(tag); m; m &= m - 1) {
+                        auto idx = g * group_size + size_t(std::countr_zero(m));
+                        if (key_equal{}(Policy::key(slots_[idx]), key)) return idx;
+                    }
+                    if (group.match_empty()) return npos;
+                    g = (g + step) & mask;
+                }
+            }
+
+        private:
+            slot_alloc_t alloc_{};
+            ctrl_t* ctrl_{const_cast<ctrl_t*>(empty_group)};
+            Slot* slots_{nullptr};
+            size_t capacity_{0};
+            size_t size_{0};
+            size_t growth_left_{0};
+
+            static inline size_t h1(size_t hash) noexcept { return hash >> 7; }
+            static inline ctrl_t h2(size_t hash) noexcept { return ctrl_t(hash & 0x7f); }
+            static inline size_t max_load(size_t capacity) noexcept { return capacity - capacity / 8; }
+
+            static inline size_t capacity_for(size_t count) noexcept {
+                size_t capacity = group_size;
+                while (max_load(capacity) < count) capacity *= 2;
+                return capacity;
+            }
+
+            inline size_t group_mask() const noexcept {
+                return capacity_ ? capacity_ / group_size - 1 : 0;
+            }
+
+            template <typename Callable>
+            inline void for_each_full(Callable f) const {
+                for (size_t g = 0; g < capacity_; g += group_size) {
+                    auto m = ~Group(ctrl_ + g).match_empty_or_deleted() & 0xffff;
+                    for (; m; m &= m - 1) f(g + size_t(std::countr_zero(m)));
+                }
+            }
+
+            // First empty or deleted slot on the probe sequence of `hash`.
+            inline size_t find_free(size_t hash) const noexcept {
+                auto mask = group_mask();
+                auto g = h1(hash) & mask;
+                for (size_t step = 1; ; step++) {
+                    if (auto m = Group(ctrl_ + g * group_size).match_empty_or_deleted(); m)
+                        return g * group_size + size_t(std::countr_zero(m));
+                    g = (g + step) & mask;
+                }
+            }
+
+            inline size_t prepare_insert(size_t hash) {
+                if (!growth_left_) {
+                    // Lots of tombstones: rehashing in place is enough.
+                    rehash(size_ < max_load(capacity_) / 2 ? capacity_ : capacity_for(size_ + 1));
+                }
+                auto idx = find_free(hash);
+                growth_left_ -= ctrl_[idx] == ctrl_empty;
+                ctrl_[idx] = h2(hash);
+                size_++;
+                return idx;
+            }
+
+            inline void insert_unique(Slot&& value) {
+                auto idx = prepare_insert(hasher{}(Policy::key(value)));
+                slot_traits::construct(alloc_, slots_ + idx, std::move(value));
+            }
+
+            inline void erase_at(size_t idx) noexcept {
+                slot_traits::destroy(alloc_, slots_ + idx);
+                ctrl_[idx] = ctrl_deleted;
+                size_--;
+            }
+
+            inline void rehash(size_t capacity) {
+                auto ctrl_alloc = ctrl_alloc_t(alloc_);
+                auto* old_ctrl = ctrl_;
+                auto* old_slots = slots_;
+                auto old_capacity = capacity_;
+
+                ctrl_ = ctrl_traits::allocate(ctrl_alloc, capacity);
+                slots_ = slot_traits::allocate(alloc_, capacity);
+                std::memset(ctrl_, ctrl_empty, capacity);
+                capacity_ = capacity;
+                growth_left_ = max_load(capacity) - size_;
+
+                for (size_t i = 0; i < old_capacity; i++) {
+                    if (old_ctrl[i] < 0) continue;
+                    auto hash = hasher{}(Policy::key(old_slots[i]));
+                    auto idx = find_free(hash);
+                    ctrl_[idx] = h2(hash);
+                    slot_traits::construct(alloc_, slots_ + idx, std::move(old_slots[i]));
+                    slot_traits::destroy(alloc_, old_slots + i);
+                }
+
+                if (old_capacity) {
+                    ctrl_traits::deallocate(ctrl_alloc, old_ctrl, old_capacity);
+                    slot_traits::deallocate(alloc_, old_slots, old_capacity);
+                }
+            }
+
+            inline void copy_from(const Table& other) {
+                if (other.empty()) return;
+                reserve(other.size());
+                other.for_each_full([this, &other](size_t i) {
+                    auto idx = prepare_insert(hasher{}(Policy::key(other.slots_[i])));
+                    slot_traits::construct(alloc_, slots_ + idx, other.slots_[i]);
+                });
+            }
+
+            inline void steal(Table& other) noexcept {
+                ctrl_ = std::exchange(other.ctrl_, const_cast<ctrl_t*>(empty_group));
+                slots_ = std::exchange(other.slots_, nullptr);
+                capacity_ = std::exchange(other.capacity_, 0);
+                size_ = std::exchange(other.size_, 0);
+                growth_left_ = std::exchange(other.growth_left_, 0);
+            }
+
+            inline void destroy() noexcept {
+                if (!capacity_) return;
+                clear();
+                auto ctrl_alloc = ctrl_alloc_t(alloc_);
+                ctrl_traits::deallocate(ctrl_alloc, ctrl_, capacity_);
+                slot_traits::deallocate(alloc_, slots_, capacity_);
+                ctrl_ = const_cast<ctrl_t*>(empty_group);
+                slots_ = nullptr;
+                capacity_ = 0;
+                growth_left_ = 0;
+            }
+        };
+    }
+
+    // Open-addressing replacements for std::unordered_set / unordered_map.
+    // Elements are stored inline (no per-node allocation), so unlike the
+    // std containers references and iterators are invalidated by any insert
+    // that grows the table. Erasing never moves other elements.
+    template <typename T, typename HashT = Hash<T>, typename Eq = std::equal_to<T>, typename Alloc = std::allocator<T>>
+    class FlatHashSet : public detail::flat::Table<T, T, detail::flat::SetPolicy, HashT, Eq, Alloc> {
+        using Base = detail::flat::Table<T, T, detail::flat::SetPolicy, HashT, Eq, Alloc>;
+
+    public:
+        using Base::Base;
+
+        template <typename... Args>
+        inline std::pair<typename Base::iterator, bool> emplace(Args&&... args) {
+            return Base::insert(T(std::forward<Args>(args)...));
+        }
+    };
+
+    template <typename K, typename V, typename HashT = Hash<K>, typename Eq = std::equal_to<K>, typename Alloc = std::allocator<std::pair<const K, V>>>
+    class FlatHashMap : public detail::flat::Table<K, std::pair<const K, V>, detail::flat::MapPolicy, HashT, Eq, Alloc> {
+        using Base = detail::flat::Table<K, std::pair<const K, V>, detail::flat::MapPolicy, HashT, Eq, Alloc>;
+
+    public:
+        using mapped_type = V;
+        using Base::Base;
+
+        template <typename... Args>
+        inline std::pair<typename Base::iterator, bool> try_emplace(const K& key, Args&&... args) {
+            return Base::emplace_impl(key, std::piecewise_construct,
+                std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        template <typename M>
+        inline std::pair<typename Base::iterator, bool> emplace(const K& key, M&& value) {
+            return try_emplace(key, std::forward<M>(value));
+        }
+
+        template <typename M>
+        inline std::pair<typename Base::iterator, bool> insert_or_assign(const K& key, M&& value) {
+            auto ret = try_emplace(key, std::forward<M>(value));
+            if (!ret.second) ret.first->second = std::forward<M>(value);
+            return ret;
+        }
+
+        inline V& operator[](const K& key) {
+            return try_emplace(key).first->second;
+        }
+
+        // Like std::unordered_map::at(), throws std::out_of_range for a key
+        // that is not in the map.
+        inline V& at(const K& key) {
+            auto it = Base::find(key);
+            if (it == Base::end()) throw std::out_of_range("aoc::FlatHashMap::at");
+            return it->second;
+        }
+        inline const V& at(const K& key) const {
+            auto it = Base::find(key);
+            if (it == Base::end()) throw std::out_of_range("aoc::FlatHashMap::at");
+            return it->second;
+        }
+    };
+
+    namespace pmr {
+        template <typename T, typename HashT = Hash<T>, typename Eq = std::equal_to<T>>
+        using FlatHashSet = aoc::FlatHashSet<T, HashT, Eq, std::pmr::polymorphic_allocator<T>>;
+
+        template <typename K, typename V, typename HashT = Hash<K>, typename Eq = std::equal_to<K>>
+        using FlatHashMap = aoc::FlatHashMap<K, V, HashT, Eq, std::pmr::polymorphic_allocator<std::pair<const K, V>>>;
+    }
+}
+
+namespace fmt {
+    template <typename T, typename H, typename E, typename A>
+    struct formatter<aoc::FlatHashSet<T, H, E, A>> {
+        template <typename ParseContext>
+        constexpr auto parse(ParseContext &ctx) { return ctx.begin(); }
+
+        template <typename FormatContext>
+        auto format(const aoc::FlatHashSet<T, H, E, A>& v, FormatContext &ctx) {
+            format_to(ctx.out(), "{{");
+            if (v.size() > 0) {
+                format_to(ctx.out(), "{}", *std::cbegin(v));
+                for (auto i = std::next(std::cbegin(v)); i != std::cend(v); i++)
+                    format_to(ctx.out(), ", {}", *i);
+            }
+            return format_to(ctx.out(), "}}");
+        }
+    };
+
+    template <typename K, typename V, typename H, typename E, typename A>
+    struct formatter<aoc::FlatHashMap<K, V, H, E, A>> {
+        template <typename ParseContext>
+        constexpr auto parse(ParseContext &ctx) { return ctx.begin(); }
+
+        template <typename FormatContext>
+        auto format(const aoc::FlatHashMap<K, V, H, E, A>& m, FormatContext &ctx) {
+            format_to(ctx.out(), "{{");
+            for (const auto& [k, v] : m)
+                format_to(ctx.out(), "\n   {} -> {}", k, v);
+            return format_to(ctx.out(), "{}}}", m.size() ? "\n" : "");
+        }
+    };
+}
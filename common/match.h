@@ -0,0 +1,511 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// A small regular expression engine whose patterns are compiled while the
+// program is being compiled. aoc::match<"pattern">(sv) anchors the pattern at
+// both ends (like std::regex_match()) and returns the capture groups, in the
+// order of their opening parenthesis, as views into `sv`.
+//
+// Supported syntax: literals, '.', '^', '$', '\d \D \s \S \w \W' and escaped
+// metacharacters, character classes ("[a-z_]", "[^:\s]"), capturing and
+// non-capturing ("(?:...)") groups, '|', and the '*', '+', '?', '{n}', '{n,}'
+// and '{n,m}' quantifiers with an optional lazy '?' suffix.
+namespace aoc {
+    template <size_t N>
+    struct fixed_string {
+        char data[N]{};
+
+        constexpr fixed_string(const char (&s)[N]) {
+            for (size_t i = 0; i < N; i++) data[i] = s[i];
+        }
+
+        constexpr std::string_view view() const { return std::string_view(data, N - 1); }
+    };
+}
+
+namespace aoc::detail::match {
+    // Deliberately not constexpr: reaching it while compiling a pattern turns
+    // into a compile-time error pointing at the offending pattern.
+    inline void pattern_error(const char*) {}
+
+    struct CharSet {
+        std::array<uint64_t, 4> bits{};
+
+        constexpr void add(unsigned char ch) {
+            bits[ch >> 6] |= uint64_t(1) << (ch & 63);
+        }
+        constexpr void add_range(unsigned char lo, unsigned char hi) {
+            for (unsigned v = lo; v <= hi; v++) add(static_cast<unsigned char>(v));
+        }
+        constexpr void add(const CharSet& other) {
+            for (size_t i = 0; i < bits.size(); i++) bits[i] |= other.bits[i];
+        }
+        constexpr CharSet& invert() {
+            for (auto& b : bits) b = ~b;
+            return *this;
+        }
+        constexpr bool contains(char ch) const {
+            auto v = static_cast<unsigned char>(ch);
+            return (bits[v >> 6] >> (v & 63)) & 1;
+        }
+
+        static constexpr CharSet single(char ch) {
+            CharSet ret{};
+            ret.add(static_cast<unsigned char>(ch));
+            return ret;
+        }
+        static constexpr CharSet digits() {
+            CharSet ret{};
+            ret.add_range('0', '9');
+            return ret;
+        }
+        static constexpr CharSet spaces() {
+            CharSet ret{};
+            ret.add(' ');
+            ret.add_range('\t', '\r');
+            return ret;
+        }
+        static constexpr CharSet word() {
+            CharSet ret = digits();
+            ret.add_range('a', 'z');
+            ret.add_range('A', 'Z');
+            ret.add('_');
+            return ret;
+        }
+        static constexpr CharSet any() {
+            return single('\n').invert();
+        }
+    };
+
+    enum class Op : uint8_t {
+        consume,
+        split,
+        jump,
+        save,
+        progress,
+        assert_begin,
+        assert_end,
+        match,
+    };
+
+    struct Instruction {
+        Op op{Op::match};
+        uint16_t x{0};
+        uint16_t y{0};
+        CharSet set{};
+    };
+
+    enum class NodeKind : uint8_t {
+        set,
+        sequence,
+        alternation,
+        repeat,
+        group,
+        begin,
+        end,
+    };
+
+    static constexpr const size_t unbounded = ~size_t(0);
+
+    struct Node {
+        NodeKind kind{NodeKind::sequence};
+        CharSet set{};
+        int first_child{-1};
+        int last_child{-1};
+        int next_sibling{-1};
+        size_t min{1};
+        size_t max{1};
+        bool greedy{true};
+        int capture{-1};
+        int loop{-1};
+    };
+
+    class Compiler {
+    public:
+        constexpr Compiler(std::string_view pattern) : pattern_(pattern) {}
+
+        constexpr std::vector<Instruction> compile() {
+            auto root = parse_alternation();
+            if (pos_ != pattern_.size()) pattern_error("unbalanced ')' in pattern");
+            std::vector<Instruction> ret{};
+            emit(root, ret);
+            ret.push_back(Instruction{Op::match});
+            if (ret.size() > 0xffff) pattern_error("pattern too large");
+            return ret;
+        }
+
+        constexpr size_t captures() const { return captures_; }
+        constexpr size_t loops() const { return loops_; }
+
+    private:
+        std::string_view pattern_{};
+        size_t pos_{0};
+        size_t captures_{0};
+        size_t loops_{0};
+        std::vector<Node> nodes_{};
+
+        constexpr bool at_end() const { return pos_ >= pattern_.size(); }
+        constexpr char peek() const { return at_end() ? '\0' : pattern_[pos_]; }
+        constexpr char take() {
+            if (at_end()) pattern_error("unexpected end of pattern");
+            return pattern_[pos_++];
+        }
+
+        constexpr int add_node(Node n) {
+            nodes_.push_back(n);
+            return int(nodes_.size() - 1);
+        }
+
+        constexpr void add_child(int parent, int child) {
+            if (nodes_[size_t(parent)].last_child < 0) nodes_[size_t(parent)].first_child = child;
+            else nodes_[size_t(nodes_[size_t(parent)].last_child)].next_sibling = child;
+            nodes_[size_t(parent)].last_child = child;
+        }
+
+        constexpr int parse_alternation() {
+            auto first = parse_sequence();
+            if (peek() != '|') return first;
+            auto alt = add_node(Node{.kind = NodeKind::alternation});
+            add_child(alt, first);
+            while (peek() == '|') {
+                pos_++;
+                add_child(alt, parse_sequence());
+            }
+            return alt;
+        }
+
+        constexpr int parse_sequence() {
+            auto seq = add_node(Node{.kind = NodeKind::sequence});
+            while (!at_end() && peek() != '|' && peek() != ')')
+                add_child(seq, parse_repeat());
+            return seq;
+        }
+
+        constexpr size_t parse_number() {
+            size_t ret{0};
+            if (peek() < '0' || peek() > '9') pattern_error("expected a number in '{}' quantifier");
+            while (peek() >= '0' && peek() <= '9') ret = ret * 10 + size_t(take() - '0');
+            return ret;
+        }
+
+        constexpr int parse_repeat() {
+            auto atom = parse_atom();
+            size_t min{1};
+            size_t max{1};
+            switch (peek()) {
+                case '*': min = 0; max = unbounded; pos_++; break;
+                case '+': min = 1; max = unbounded; pos_++; break;
+                case '?': min = 0; max = 1; pos_++; break;
+                case '{': {
+                    pos_++;
+                    min = max = parse_number();
+                    if (peek() == ',') {
+                        pos_++;
+                        max = peek() == '}' ? unbounded : parse_number();
+                    }
+                    if (take() != '}' || max < min) pattern_error("malformed '{}' quantifier");
+                    break;
+                }
+                default: return atom;
+            }
+            bool greedy{true};
+            if (peek() == '?') {
+                greedy = false;
+                pos_++;
+            }
+            auto loop = max == unbounded ? int(loops_++) : -1;
+            auto rep = add_node(Node{.kind = NodeKind::repeat, .min = min, .max = max, .greedy = greedy, .loop = loop});
+            add_child(rep, atom);
+            return rep;
+        }
+
+        constexpr CharSet parse_escape(bool in_class) {
+            auto ch = take();
+            switch (ch) {
+                case 'd': return CharSet::digits();
+                case 'D': return CharSet::digits().invert();
+                case 's': return CharSet::spaces();
+                case 'S': return CharSet::spaces().invert();
+                case 'w': return CharSet::word();
+                case 'W': return CharSet::word().invert();
+                case 't': return CharSet::single('\t');
+                case 'n': return CharSet::single('\n');
+                case 'r': return CharSet::single('\r');
+                default: {
+                    if ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9'))
+                        pattern_error(in_class ? "unsupported escape in character class" : "unsupported escape");
+                    return CharSet::single(ch);
+                }
+            }
+        }
+
+        constexpr CharSet parse_class() {
+            CharSet ret{};
+            bool negate{false};
+            if (peek() == '^') {
+                negate = true;
+                pos_++;
+            }
+            bool first{true};
+            while (first || peek() != ']') {
+                first = false;
+                auto ch = take();
+                if (ch == '\\') {
+                    ret.add(parse_escape(true));
+                    continue;
+                }
+                if (peek() == '-' && pos_ + 1 < pattern_.size() && pattern_[pos_ + 1] != ']') {
+                    pos_++;
+                    auto hi = take();
+                    if (hi == '\\') hi = take();
+                    if (static_cast<unsigned char>(hi) < static_cast<unsigned char>(ch))
+                        pattern_error("inverted range in character class");
+                    ret.add_range(static_cast<unsigned char>(ch), static_cast<unsigned char>(hi));
+                    continue;
+                }
+                ret.add(static_cast<unsigned char>(ch));
+            }
+            pos_++;
+            return negate ? ret.invert() : ret;
+        }
+
+        constexpr int parse_atom() {
+            auto ch = take();
+            switch (ch) {
+                case '(': {
+                    int capture{-1};
+                    if (peek() == '?') {
+                        pos_++;
+                        if (take() != ':') pattern_error("only (?:...) groups are supported");
+                    } else {
+                        capture = int(captures_++);
+                    }
+                    auto group = add_node(Node{.kind = NodeKind::group, .capture = capture});
+                    add_child(group, parse_alternation());
+                    if (take() != ')') pattern_error("missing ')' in pattern");
+                    return group;
+                }
+                case '[': return add_node(Node{.kind = NodeKind::set, .set = parse_class()});
+                case '.': return add_node(Node{.kind = NodeKind::set, .set = CharSet::any()});
+                case '^': return add_node(Node{.kind = NodeKind::begin});
+                case '$': return add_node(Node{.kind = NodeKind::end});
+                case '\\': return add_node(Node{.kind = NodeKind::set, .set = parse_escape(false)});
+                case '*': [[fallthrough]];
+                case '+': [[fallthrough]];
+                case '?': [[fallthrough]];
+                case '{': {
+                    pattern_error("quantifier without a preceding atom");
+                    return -1;
+                }
+                default: return add_node(Node{.kind = NodeKind::set, .set = CharSet::single(ch)});
+            }
+        }
+
+        static constexpr uint16_t here(const std::vector<Instruction>& prog) {
+            return uint16_t(prog.size());
+        }
+
+        constexpr void emit(int idx, std::vector<Instruction>& prog) const {
+            const auto& node = nodes_[size_t(idx)];
+            switch (node.kind) {
+                case NodeKind::set: {
+                    prog.push_back(Instruction{.op = Op::consume, .set = node.set});
+                    break;
+                }
+                case NodeKind::sequence: {
+                    for (auto c = node.first_child; c >= 0; c = nodes_[size_t(c)].next_sibling)
+                        emit(c, prog);
+                    break;
+                }
+                case NodeKind::group: {
+                    if (node.capture >= 0) prog.push_back(Instruction{.op = Op::save, .x = uint16_t(2 * node.capture)});
+                    emit(node.first_child, prog);
+                    if (node.capture >= 0) prog.push_back(Instruction{.op = Op::save, .x = uint16_t(2 * node.capture + 1)});
+                    break;
+                }
+                case NodeKind::alternation: {
+                    std::vector<size_t> jumps{};
+                    for (auto c = node.first_child; c >= 0; c = nodes_[size_t(c)].next_sibling) {
+                        if (nodes_[size_t(c)].next_sibling < 0) {
+                            emit(c, prog);
+                            break;
+                        }
+                        auto split = prog.size();
+                        prog.push_back(Instruction{.op = Op::split});
+                        prog[split].x = here(prog);
+                        emit(c, prog);
+                        jumps.push_back(prog.size());
+                        prog.push_back(Instruction{.op = Op::jump});
+                        prog[split].y = here(prog);
+                    }
+                    for (auto j : jumps) prog[j].x = here(prog);
+                    break;
+                }
+                case NodeKind::repeat: {
+                    for (size_t i = 0; i < node.min; i++) emit(node.first_child, prog);
+                    if (node.max == unbounded) {
+                        // Every iteration records where it started and fails
+                        // if the body consumed nothing, or a body that can
+                        // match empty would loop forever. The loop slots
+                        // follow the capture slots.
+                        auto slot = uint16_t(2 * captures_ + size_t(node.loop));
+                        auto split = prog.size();
+                        prog.push_back(Instruction{.op = Op::split});
+                        auto body = here(prog);
+                        prog.push_back(Instruction{.op = Op::save, .x = slot});
+                        emit(node.first_child, prog);
+                        prog.push_back(Instruction{.op = Op::progress, .x = slot});
+                        prog.push_back(Instruction{.op = Op::jump, .x = uint16_t(split)});
+                        link_split(prog[split], body, here(prog), node.greedy);
+                    } else {
+                        std::vector<size_t> splits{};
+                        for (size_t i = node.min; i < node.max; i++) {
+                            splits.push_back(prog.size());
+                            prog.push_back(Instruction{.op = Op::split});
+                            emit(node.first_child, prog);
+                        }
+                        for (auto s : splits) link_split(prog[s], uint16_t(s + 1), here(prog), node.greedy);
+                    }
+                    break;
+                }
+                case NodeKind::begin: {
+                    prog.push_back(Instruction{.op = Op::assert_begin});
+                    break;
+                }
+                case NodeKind::end: {
+                    prog.push_back(Instruction{.op = Op::assert_end});
+                    break;
+                }
+            }
+        }
+
+        static constexpr void link_split(Instruction& split, uint16_t body, uint16_t skip, bool greedy) {
+            split.x = greedy ? body : skip;
+            split.y = greedy ? skip : body;
+        }
+    };
+
+    template <size_t Capacity>
+    struct Program {
+        std::array<Instruction, Capacity> code{};
+        size_t size{0};
+        size_t captures{0};
+        size_t loops{0};
+    };
+
+    template <fixed_string Pattern, size_t Capacity>
+    constexpr Program<Capacity> compile() {
+        Compiler c(Pattern.view());
+        auto prog = c.compile();
+        Program<Capacity> ret{};
+        ret.size = prog.size();
+        ret.captures = c.captures();
+        ret.loops = c.loops();
+        if (prog.size() <= Capacity)
+            for (size_t i = 0; i < prog.size(); i++) ret.code[i] = prog[i];
+        return ret;
+    }
+
+    // Bounded quantifiers are unrolled, so the size of a program is only
+    // known once it has been compiled. Nearly every pattern fits in a buffer
+    // a few times its length and is compiled exactly once; a pattern that
+    // does not is compiled a second time into a buffer of the size the first
+    // attempt reported.
+    template <fixed_string Pattern>
+    struct Compiled {
+    private:
+        static constexpr size_t guess = 4 * Pattern.view().size() + 8;
+        static constexpr auto first = compile<Pattern, guess>();
+        static constexpr auto result = [] {
+            if constexpr (first.size <= guess) return first;
+            else return compile<Pattern, first.size>();
+        }();
+
+    public:
+        static constexpr size_t captures = result.captures;
+        static constexpr size_t slots = 2 * captures + result.loops;
+        static constexpr size_t size = result.size;
+        static constexpr std::array<Instruction, size> program = [] {
+            std::array<Instruction, size> ret{};
+            for (size_t i = 0; i < size; i++) ret[i] = result.code[i];
+            return ret;
+        }();
+    };
+
+    // Backtracking interpreter; only the alternatives of a split and the capture
+    // saves recurse, straight-line code runs in the loop.
+    template <size_t Slots>
+    inline bool run(const Instruction* prog, size_t pc, const char* sp, const char* begin, const char* end,
+                    std::array<const char*, Slots>& slots) noexcept
+    {
+        while (true) {
+            const auto& ins = prog[pc];
+            switch (ins.op) {
+                case Op::consume: {
+                    if (sp == end || !ins.set.contains(*sp)) return false;
+                    sp++;
+                    pc++;
+                    break;
+                }
+                case Op::split: {
+                    if (run(prog, ins.x, sp, begin, end, slots)) return true;
+                    pc = ins.y;
+                    break;
+                }
+                case Op::jump: {
+                    pc = ins.x;
+                    break;
+                }
+                case Op::save: {
+                    auto old = slots[ins.x];
+                    slots[ins.x] = sp;
+                    if (run(prog, pc + 1, sp, begin, end, slots)) return true;
+                    slots[ins.x] = old;
+                    return false;
+                }
+                case Op::progress: {
+                    if (slots[ins.x] == sp) return false;
+                    pc++;
+                    break;
+                }
+                case Op::assert_begin: {
+                    if (sp != begin) return false;
+                    pc++;
+                    break;
+                }
+                case Op::assert_end: {
+                    if (sp != end) return false;
+                    pc++;
+                    break;
+                }
+                case Op::match: {
+                    return sp == end;
+                }
+            }
+        }
+    }
+}
+
+namespace aoc {
+    template <fixed_string Pattern>
+    inline std::optional<std::array<std::string_view, detail::match::Compiled<Pattern>::captures>>
+    match(std::string_view sv) noexcept {
+        using compiled = detail::match::Compiled<Pattern>;
+        std::array<const char*, compiled::slots> slots{};
+        if (!detail::match::run(compiled::program.data(), 0, sv.data(), sv.data(), sv.data() + sv.size(), slots))
+            return std::nullopt;
+
+        std::array<std::string_view, compiled::captures> ret{};
+        for (size_t i = 0; i < compiled::captures; i++) {
+            if (slots[2 * i] && slots[2 * i + 1])
+                ret[i] = std::string_view(slots[2 * i], size_t(slots[2 * i + 1] - slots[2 * i]));
+        }
+        return ret;
+    }
+}
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+#include "bigint.h"
+#include "flat_hash.h"
+
+namespace aoc {
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+    constexpr inline T gcd(T v1, T v2) {
+        if constexpr (std::is_signed_v<T>) {
+            if (v1 < 0) v1 = -v1;
+            if (v2 < 0) v2 = -v2;
+        }
+        while (v2) {
+            T t = v1 % v2;
+            v1 = v2;
+            v2 = t;
+        }
+        return v1;
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+    constexpr inline T lcm(T v1, T v2) {
+        if (!v1 || !v2) return 0;
+        return v1 / gcd(v1, v2) * v2;
+    }
+
+    // Extended Euclid: returns (g, x, y) with a * x + b * y == g == gcd(a, b).
+    template <typename T, typename = std::enable_if_t<std::is_signed_v<T> || std::is_same_v<T, __int128>>>
+    inline constexpr std::tuple<T, T, T> extended_gcd(T a, T b) noexcept {
+        T x0{1}, x1{0}, y0{0}, y1{1};
+        while (b != 0) {
+            auto q = a / b;
+            std::tie(a, b) = std::make_tuple(b, a - q * b);
+            std::tie(x0, x1) = std::make_tuple(x1, x0 - q * x1);
+            std::tie(y0, y1) = std::make_tuple(y1, y0 - q * y1);
+        }
+        if (a < 0) return {-a, -x0, -y0};
+        return {a, x0, y0};
+    }
+
+    inline constexpr uint64_t mulmod(uint64_t a, uint64_t b, uint64_t m) noexcept {
+        return uint64_t(static_cast<unsigned __int128>(a) * b % m);
+    }
+
+    // Inverse of `a` modulo `m`, if gcd(a, m) == 1.
+    inline constexpr std::optional<uint64_t> invmod(uint64_t a, uint64_t m) noexcept {
+        if (m == 0) return std::nullopt;
+        auto [g, x, y] = extended_gcd<__int128>(a % m, m);
+        if (g != 1) return std::nullopt;
+        x %= m;
+        if (x < 0) x += m;
+        return uint64_t(x);
+    }
+
+    // Montgomery arithmetic modulo an odd n < 2^64. Values are kept in
+    // Montgomery form (a * 2^64 mod n); to() and from() convert. A
+    // multiplication is three 64x64 multiplies and no division, which is
+    // what makes long exponentiation and discrete log chains cheap.
+    class Montgomery {
+    public:
+        inline explicit constexpr Montgomery(uint64_t n) noexcept : n_(n) {
+            // Newton's iteration doubles the correct low bits each round;
+            // n is its own inverse modulo 8, so 5 rounds give 96 > 64 bits.
+            uint64_t inv{n};
+            for (int i = 0; i < 5; i++) inv *= 2 - n * inv;
+            n_inv_ = inv;
+            auto r = (0 - n) % n;
+            r2_ = mulmod(r, r, n);
+        }
+
+        inline constexpr uint64_t modulus() const noexcept { return n_; }
+        inline constexpr uint64_t to(uint64_t a) const noexcept { return reduce(static_cast<unsigned __int128>(a % n_) * r2_); }
+        inline constexpr uint64_t from(uint64_t a) const noexcept { return reduce(a); }
+        inline constexpr uint64_t one() const noexcept { return to(1); }
+
+        inline constexpr uint64_t mul(uint64_t a, uint64_t b) const noexcept {
+            return reduce(static_cast<unsigned __int128>(a) * b);
+        }
+
+        inline constexpr uint64_t pow(uint64_t a, uint64_t e) const noexcept {
+            auto ret = one();
+            while (e) {
+                if (e & 1) ret = mul(ret, a);
+                a = mul(a, a);
+                e >>= 1;
+            }
+            return ret;
+        }
+
+    private:
+        uint64_t n_;
+        uint64_t n_inv_{0};
+        uint64_t r2_{0};
+
+        // REDC: t * 2^-64 mod n for t < n * 2^64. Subtracting the high halves
+        // instead of adding keeps everything in range for any odd n.
+        inline constexpr uint64_t reduce(unsigned __int128 t) const noexcept {
+            auto m = uint64_t(t) * n_inv_;
+            auto hi = uint64_t(t >> 64);
+            auto mn = uint64_t((static_cast<unsigned __int128>(m) * n_) >> 64);
+            return hi >= mn ? hi - mn : hi - mn + n_;
+        }
+    };
+
+    // Square-and-multiply; Montgomery for odd moduli, 128 bit remainders
+    // otherwise.
+    inline constexpr uint64_t powmod(uint64_t base, uint64_t exp, uint64_t m) noexcept {
+        if (m == 1) return 0;
+        if (m & 1) {
+            Montgomery mont(m);
+            return mont.from(mont.pow(mont.to(base), exp));
+        }
+        uint64_t ret{1};
+        base %= m;
+        while (exp) {
+            if (exp & 1) ret = mulmod(ret, base, m);
+            base = mulmod(base, base, m);
+            exp >>= 1;
+        }
+        return ret;
+    }
+
+    // Largest baby step table discrete_log() builds, so bounds up to 2^50 can
+    // be searched. At a 7/8 maximum load 2^25 entries take a table of 2^26
+    // slots, 16 bytes each plus a control byte: a little over 1 GiB.
+    inline constexpr const uint64_t discrete_log_max_baby_steps = uint64_t(1) << 25;
+
+    // Baby-step giant-step: the smallest x >= 0 with base^x == target (mod m),
+    // searching x < `bound` (default: m, which covers any group order). Time
+    // and memory are O(sqrt(bound)). Returns std::nullopt if there is no
+    // solution, if gcd(base, m) != 1, or if the bound needs more than
+    // discrete_log_max_baby_steps baby steps.
+    inline std::optional<uint64_t> discrete_log(uint64_t base, uint64_t target, uint64_t m, uint64_t bound = 0) {
+        if (m == 1) return 0;
+        base %= m;
+        target %= m;
+        if (!bound) bound = m;
+        auto base_inv = invmod(base, m);
+        if (!base_inv) return std::nullopt;
+
+        auto steps = uint64_t(std::ceil(std::sqrt(double(bound))));
+        if (steps > discrete_log_max_baby_steps) return std::nullopt;
+        while (steps * steps < bound) steps++;
+        if (steps > discrete_log_max_baby_steps) return std::nullopt;
+
+        // Baby steps remember the first exponent at which every power of
+        // `base` appears, so the first match below is the smallest solution.
+        // Giant steps walk target * base^(-steps * i).
+        auto search = [&](auto mul, uint64_t one, uint64_t b, uint64_t t, uint64_t giant) -> std::optional<uint64_t> {
+            FlatHashMap<uint64_t, uint64_t> baby{};
+            baby.reserve(size_t(steps));
+            auto v = one;
+            for (uint64_t j = 0; j < steps; j++) {
+                baby.try_emplace(v, j);
+                v = mul(v, b);
+            }
+            auto gamma = t;
+            for (uint64_t i = 0; i < steps; i++) {
+                if (auto it = baby.find(gamma); it != baby.end()) {
+                    auto x = i * steps + it->second;
+                    if (x < bound) return x;
+                    return std::nullopt;
+                }
+                gamma = mul(gamma, giant);
+            }
+            return std::nullopt;
+        };
+
+        if (m & 1) {
+            Montgomery mont(m);
+            auto giant = mont.pow(mont.to(*base_inv), steps);
+            return search([&](uint64_t a, uint64_t b) { return mont.mul(a, b); },
+                mont.one(), mont.to(base), mont.to(target), giant);
+        }
+        auto giant = powmod(*base_inv, steps, m);
+        return search([m](uint64_t a, uint64_t b) { return mulmod(a, b, m); }, 1, base, target, giant);
+    }
+
+    // x == remainder (mod modulus)
+    struct Congruence {
+        uint64_t remainder{0};
+        uint64_t modulus{1};
+    };
+
+    // Every solution of a congruence system is value + k * modulus, where
+    // modulus is the lcm of the moduli and value the smallest solution.
+    struct CrtSolution {
+        BigUint value{};
+        BigUint modulus{1};
+    };
+
+    // Chinese remainder theorem for moduli that need not be coprime; returns
+    // std::nullopt if the congruences contradict each other. All moduli must
+    // be non-zero.
+    //
+    // Congruences are merged one at a time into x == r (mod M): x = r + M * k
+    // with M * k == a - r (mod m), solvable iff g = gcd(M, m) divides a - r,
+    // and then k == (a - r) / g * (M / g)^-1 (mod m / g). Only r mod m and
+    // M mod m are ever needed, so r and M stay in 128 bits while they fit
+    // and move to a BigUint once they do not.
+    inline std::optional<CrtSolution> crt(std::span<const Congruence> system) {
+        struct Step {
+            uint64_t k{0};
+            uint64_t factor{1};
+        };
+        auto merge = [](uint64_t r_mod_m, uint64_t big_m_mod_m, const Congruence& c) -> std::optional<Step> {
+            auto m = c.modulus;
+            auto g = gcd(big_m_mod_m, m);
+            // a - r (mod m) without going through a + m, which wraps for
+            // moduli above 2^63.
+            auto a = c.remainder % m;
+            auto diff = a >= r_mod_m ? a - r_mod_m : a + (m - r_mod_m);
+            if (diff % g) return std::nullopt;
+            auto factor = m / g;
+            auto inv = invmod(big_m_mod_m / g, factor);
+            return Step{mulmod(diff / g, inv.value(), factor), factor};
+        };
+
+        unsigned __int128 r{0}, big_m{1};
+        size_t i{0};
+        for (; i < system.size(); i++) {
+            const auto& c = system[i];
+            auto step = merge(uint64_t(r % c.modulus), uint64_t(big_m % c.modulus), c);
+            if (!step) return std::nullopt;
+            unsigned __int128 next{0};
+            if (__builtin_mul_overflow(big_m, step->factor, &next)) break;
+            // r < M and k < factor, so r + M * k < M * factor fits as well.
+            r += big_m * step->k;
+            big_m = next;
+        }
+
+        CrtSolution ret{BigUint(r), BigUint(big_m)};
+        for (; i < system.size(); i++) {
+            const auto& c = system[i];
+            auto step = merge(ret.value % c.modulus, ret.modulus % c.modulus, c);
+            if (!step) return std::nullopt;
+            ret.value += ret.modulus * step->k;
+            ret.modulus *= step->factor;
+        }
+        return ret;
+    }
+}
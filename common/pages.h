@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include <sys/mman.h>
+
+namespace aoc {
+    // Large zero-filled array backed by an anonymous mapping. Pages are only
+    // faulted in when first touched, so tables indexed by value (and mostly
+    // left at zero) cost nothing up front. With `huge` the kernel is asked to
+    // back the range with transparent huge pages, which removes most of the
+    // TLB misses of random access over hundreds of megabytes; if THP is not
+    // available the advice is silently ignored.
+    template <typename T>
+    class PageArray {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>);
+
+    public:
+        inline PageArray() = default;
+        inline PageArray(const PageArray&) = delete;
+        inline PageArray& operator=(const PageArray&) = delete;
+        inline PageArray(PageArray&& other) noexcept { *this = std::move(other); }
+        inline PageArray& operator=(PageArray&& other) noexcept {
+            if (this != &other) {
+                release();
+                data_ = std::exchange(other.data_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+            }
+            return *this;
+        }
+        inline ~PageArray() {
+            release();
+        }
+
+        static inline std::optional<PageArray> allocate(size_t count, bool huge = false) {
+            PageArray ret{};
+            if (!count) return ret;
+            auto bytes = count * sizeof(T);
+            auto addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (addr == MAP_FAILED) {
+                fmt::print(std::cerr, "Failed to map {} bytes: {}\n", bytes, std::strerror(errno));
+                return std::nullopt;
+            }
+#if defined(MADV_HUGEPAGE)
+            if (huge) ::madvise(addr, bytes, MADV_HUGEPAGE);
+#endif
+            ret.data_ = static_cast<T*>(addr);
+            ret.size_ = count;
+            return ret;
+        }
+
+        inline T* data() noexcept { return data_; }
+        inline const T* data() const noexcept { return data_; }
+        inline size_t size() const noexcept { return size_; }
+        inline T& operator[](size_t i) noexcept { return data_[i]; }
+        inline const T& operator[](size_t i) const noexcept { return data_[i]; }
+        inline std::span<T> span() noexcept { return {data_, size_}; }
+        inline std::span<const T> span() const noexcept { return {data_, size_}; }
+
+    private:
+        T* data_{nullptr};
+        size_t size_{0};
+
+        inline void release() noexcept {
+            if (data_) ::munmap(data_, size_ * sizeof(T));
+            data_ = nullptr;
+            size_ = 0;
+        }
+    };
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#if !defined(AOC_PROFILE)
+#define AOC_PROFILE 0
+#endif
+
+// Named timers and counters for finding hot spots inside a day:
+//
+//   aoc::ScopeTimer timer{"day11 steady state"};
+//   aoc::counter("day11 generations") += 1;
+//
+// Values are aggregated per name across all threads and printed, sorted by
+// total, to stderr when the process exits. Unless AOC_PROFILE is 1 everything
+// here is an empty inline no-op. A counter() lookup takes a lock, so hot loops
+// should keep the handle around (`static auto c = aoc::counter("...")`).
+namespace aoc::profile {
+    static constexpr const bool enabled = AOC_PROFILE;
+
+#if AOC_PROFILE
+    struct Slot {
+        std::atomic<uint64_t> updates{0};
+        std::atomic<uint64_t> total{0};
+    };
+
+    class Registry {
+    public:
+        static inline Registry& instance() {
+            static Registry g_instance;
+            return g_instance;
+        }
+
+        inline ~Registry() {
+            report(std::cerr);
+        }
+
+        inline Slot& timer(std::string_view name) { return get(timers_, name); }
+        inline Slot& counter(std::string_view name) { return get(counters_, name); }
+
+        inline void report(std::ostream& out) {
+            auto lock = std::lock_guard(mutex_);
+            if (!timers_.empty()) {
+                fmt::print(out, "{:<40} {:>10} {:>14} {:>14}\n", "timer", "calls", "total ms", "mean us");
+                for (auto& [name, slot] : sorted(timers_)) {
+                    auto calls = slot->updates.load();
+                    auto total = slot->total.load();
+                    fmt::print(out, "{:<40} {:>10} {:>14.3f} {:>14.3f}\n",
+                        name, calls, double(total) / 1e6, calls ? double(total) / 1e3 / double(calls) : 0.0);
+                }
+            }
+            if (!counters_.empty()) {
+                fmt::print(out, "{:<40} {:>10} {:>14}\n", "counter", "updates", "total");
+                for (auto& [name, slot] : sorted(counters_))
+                    fmt::print(out, "{:<40} {:>10} {:>14}\n", name, slot->updates.load(), slot->total.load());
+            }
+        }
+
+    private:
+        using Table = std::map<std::string, std::unique_ptr<Slot>, std::less<>>;
+
+        std::mutex mutex_{};
+        Table timers_{};
+        Table counters_{};
+
+        inline Slot& get(Table& table, std::string_view name) {
+            auto lock = std::lock_guard(mutex_);
+            auto it = table.find(name);
+            if (it == table.end())
+                it = table.emplace(std::string(name), std::make_unique<Slot>()).first;
+            return *it->second;
+        }
+
+        static inline std::vector<std::pair<std::string_view, Slot*>> sorted(const Table& table) {
+            std::vector<std::pair<std::string_view, Slot*>> ret{};
+            for (auto& [name, slot] : table) ret.emplace_back(name, slot.get());
+            std::stable_sort(ret.begin(), ret.end(), [](const auto& a, const auto& b) {
+                return a.second->total.load() > b.second->total.load();
+            });
+            return ret;
+        }
+    };
+
+    inline void record(std::string_view name, std::chrono::nanoseconds elapsed) {
+        auto& slot = Registry::instance().timer(name);
+        slot.updates.fetch_add(1, std::memory_order_relaxed);
+        slot.total.fetch_add(uint64_t(elapsed.count()), std::memory_order_relaxed);
+    }
+
+    class Counter {
+    public:
+        inline explicit Counter(std::string_view name) : slot_(&Registry::instance().counter(name)) {}
+
+        inline Counter& operator+=(uint64_t n) noexcept {
+            slot_->updates.fetch_add(1, std::memory_order_relaxed);
+            slot_->total.fetch_add(n, std::memory_order_relaxed);
+            return *this;
+        }
+        inline Counter& operator++() noexcept { return *this += 1; }
+
+    private:
+        Slot* slot_;
+    };
+
+    class ScopeTimer {
+    public:
+        inline explicit ScopeTimer(std::string_view name)
+            : slot_(Registry::instance().timer(name)), start_(std::chrono::steady_clock::now())
+        {}
+        inline ScopeTimer(const ScopeTimer&) = delete;
+        inline ScopeTimer& operator=(const ScopeTimer&) = delete;
+        inline ~ScopeTimer() {
+            auto elapsed = std::chrono::nanoseconds(std::chrono::steady_clock::now() - start_);
+            slot_.updates.fetch_add(1, std::memory_order_relaxed);
+            slot_.total.fetch_add(uint64_t(elapsed.count()), std::memory_order_relaxed);
+        }
+
+    private:
+        Slot& slot_;
+        std::chrono::steady_clock::time_point start_;
+    };
+#else
+    inline constexpr void record(std::string_view, std::chrono::nanoseconds) noexcept {}
+
+    class Counter {
+    public:
+        inline constexpr explicit Counter(std::string_view) noexcept {}
+        inline constexpr Counter& operator+=(uint64_t) noexcept { return *this; }
+        inline constexpr Counter& operator++() noexcept { return *this; }
+    };
+
+    class ScopeTimer {
+    public:
+        inline constexpr explicit ScopeTimer(std::string_view) noexcept {}
+    };
+#endif
+}
+
+namespace aoc {
+    using profile::ScopeTimer;
+
+    inline profile::Counter counter(std::string_view name) {
+        return profile::Counter(name);
+    }
+}
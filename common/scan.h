@@ -0,0 +1,111 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace aoc::scan {
+    // Same set as std::isspace() in the "C" locale, minus the locale lookup.
+    inline constexpr bool is_space(char ch) noexcept {
+        return ch == ' ' || static_cast<unsigned char>(ch - '\t') < 5;
+    }
+
+    static constexpr const size_t block_size = 64;
+
+    // Bit `i` of the result is set iff p[i] is either c1 or c2. Reads exactly
+    // block_size bytes starting at p.
+    inline uint64_t match_block(const char* p, char c1, char c2) noexcept {
+#if defined(__AVX2__)
+        const auto n1 = _mm256_set1_epi8(c1);
+        const auto n2 = _mm256_set1_epi8(c2);
+        const auto v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const auto v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+        const auto m0 = uint32_t(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v0, n1), _mm256_cmpeq_epi8(v0, n2))));
+        const auto m1 = uint32_t(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v1, n1), _mm256_cmpeq_epi8(v1, n2))));
+        return uint64_t(m0) | (uint64_t(m1) << 32);
+#elif defined(__SSE2__)
+        const auto n1 = _mm_set1_epi8(c1);
+        const auto n2 = _mm_set1_epi8(c2);
+        uint64_t ret{0};
+        for (size_t i = 0; i < block_size; i += 16) {
+            const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            const auto m = uint32_t(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, n1), _mm_cmpeq_epi8(v, n2))));
+            ret |= uint64_t(m) << i;
+        }
+        return ret;
+#else
+        uint64_t ret{0};
+        for (size_t i = 0; i < block_size; i++)
+            ret |= uint64_t((p[i] == c1) | (p[i] == c2)) << i;
+        return ret;
+#endif
+    }
+
+    // Same as match_block() for a short tail of `count` (< block_size) bytes.
+    inline uint64_t match_tail(const char* p, size_t count, char c1, char c2) noexcept {
+        uint64_t ret{0};
+        for (size_t i = 0; i < count; i++)
+            ret |= uint64_t((p[i] == c1) | (p[i] == c2)) << i;
+        return ret;
+    }
+
+    // Walks a buffer one block at a time and hands out the offsets of every
+    // occurrence of c1 or c2 in increasing order. Each block is classified once,
+    // so consecutive short fields (lines, comma separated values) cost one bit
+    // scan each instead of a fresh memchr() call.
+    class Scanner {
+    public:
+        inline Scanner() = default;
+        inline Scanner(std::string_view sv, char c1) noexcept : Scanner(sv, c1, c1) {}
+        inline Scanner(std::string_view sv, char c1, char c2) noexcept
+            : data_(sv.data()), size_(sv.size()), c1_(c1), c2_(c2)
+        {}
+
+        // Offset of the next match at or after `from`, or size() if there is none.
+        // The classified block is cached, so walking forward through a buffer
+        // touches every byte once.
+        inline size_t next(size_t from) noexcept {
+            if (from >= size_) return size_;
+            auto base = from & ~(block_size - 1);
+            if (base != block_) {
+                block_ = base;
+                load();
+            }
+            while (true) {
+                auto pending = from > block_ ? mask_ & (~uint64_t(0) << (from - block_)) : mask_;
+                if (pending) return block_ + size_t(std::countr_zero(pending));
+                if (block_ + block_size >= size_) return size_;
+                block_ += block_size;
+                load();
+            }
+        }
+
+        inline size_t size() const noexcept { return size_; }
+
+    private:
+        const char* data_{nullptr};
+        size_t size_{0};
+        size_t block_{~size_t(0)};
+        uint64_t mask_{0};
+        char c1_{0};
+        char c2_{0};
+
+        inline void load() noexcept {
+            if (block_ >= size_) mask_ = 0;
+            else if (block_ + block_size <= size_) mask_ = match_block(data_ + block_, c1_, c2_);
+            else mask_ = match_tail(data_ + block_, size_ - block_, c1_, c2_);
+        }
+    };
+
+    // Offset of the first occurrence of c at or after `from`, or sv.size().
+    inline size_t find(std::string_view sv, char c, size_t from = 0) noexcept {
+        return Scanner(sv, c).next(from);
+    }
+}
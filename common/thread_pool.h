@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace aoc {
+    // Fixed set of worker threads pulling jobs off a single FIFO queue. Jobs
+    // still queued when the pool is destroyed are run before the workers exit.
+    class ThreadPool {
+    public:
+        inline explicit ThreadPool(size_t threads = default_size()) {
+            if (!threads) threads = 1;
+            workers_.reserve(threads);
+            for (size_t i = 0; i < threads; i++)
+                workers_.emplace_back([this] { worker(); });
+        }
+        inline ThreadPool(const ThreadPool&) = delete;
+        inline ThreadPool& operator=(const ThreadPool&) = delete;
+        inline ~ThreadPool() {
+            {
+                auto lock = std::lock_guard(mutex_);
+                stopping_ = true;
+            }
+            cv_.notify_all();
+            for (auto& t : workers_) t.join();
+        }
+
+        static inline size_t default_size() noexcept {
+            return std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        inline size_t size() const noexcept { return workers_.size(); }
+
+        template <typename Callable>
+        inline std::future<std::invoke_result_t<Callable>> submit(Callable&& f) {
+            using Result = std::invoke_result_t<Callable>;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Callable>(f));
+            auto ret = task->get_future();
+            {
+                auto lock = std::lock_guard(mutex_);
+                jobs_.emplace_back([task] { (*task)(); });
+            }
+            cv_.notify_one();
+            return ret;
+        }
+
+    private:
+        std::vector<std::thread> workers_{};
+        std::deque<std::function<void()>> jobs_{};
+        std::mutex mutex_{};
+        std::condition_variable cv_{};
+        bool stopping_{false};
+
+        inline void worker() {
+            while (true) {
+                std::function<void()> job{};
+                {
+                    auto lock = std::unique_lock(mutex_);
+                    cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+                    if (jobs_.empty()) return;
+                    job = std::move(jobs_.front());
+                    jobs_.pop_front();
+                }
+                job();
+            }
+        }
+    };
+}
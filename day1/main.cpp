@@ -1,36 +1,119 @@
 #include <aoc.h>
 
-int main() {
-    std::vector<uint64_t> numbers{};
-    while (!std::cin.eof()) {
-        int tmp{};
-        std::cin >> tmp;
-        numbers.push_back(tmp);
-    }
+namespace day1 {
+    // Picks k entries of `sorted` (ascending) adding up to `target` into
+    // `picked`. The last two entries are found with two pointers; every
+    // level above fixes its smallest entry and recurses on the suffix, so
+    // the whole search is O(n^(k-1)), and most of it is cut off early:
+    // values repeat at most once per level, and a level stops as soon as k
+    // copies of its smallest entry overshoot the target.
+    static inline bool k_sum_sorted(std::span<const uint64_t> sorted, uint64_t target, size_t k, std::vector<uint64_t>& picked) {
+        if (sorted.size() < k) return false;
+        if (k == 1) {
+            if (!std::binary_search(sorted.begin(), sorted.end(), target)) return false;
+            picked.push_back(target);
+            return true;
+        }
+        if (k == 2) {
+            size_t lo{0}, hi{sorted.size() - 1};
+            while (lo < hi) {
+                auto sum = static_cast<unsigned __int128>(sorted[lo]) + sorted[hi];
+                if (sum == target) {
+                    picked.push_back(sorted[lo]);
+                    picked.push_back(sorted[hi]);
+                    return true;
+                }
+                if (sum < target) lo++;
+                else hi--;
+            }
+            return false;
+        }
 
-    uint64_t r1{};
-    uint64_t r2{};
+        // Largest sum the remaining k - 1 entries could possibly reach.
+        unsigned __int128 top{0};
+        for (size_t i = sorted.size() - (k - 1); i < sorted.size(); i++) top += sorted[i];
 
-    for (size_t i = 0; i < numbers.size(); i++) {
-        if (numbers[i] >= 2020) continue;
+        for (size_t i = 0; i + k <= sorted.size(); i++) {
+            auto a = sorted[i];
+            if (a > target / k) break;
+            if (i && a == sorted[i - 1]) continue;
+            if (a + top < target) continue;
+            picked.push_back(a);
+            if (k_sum_sorted(sorted.subspan(i + 1), target - a, k - 1, picked)) return true;
+            picked.pop_back();
+        }
+        return false;
+    }
 
-        for (size_t j = 0; j < numbers.size(); j++) {
-            if (numbers[j] >= 2020) continue;
+    // Finds k entries (at distinct positions) of `numbers` that add up to
+    // `target`. Entries are non-negative, so anything above the target is
+    // dropped up front, and no value is needed more than k times; with a
+    // small target that leaves at most k * (target + 1) candidates however
+    // long the report is.
+    static inline std::optional<std::vector<uint64_t>> k_sum(std::span<const uint64_t> numbers, uint64_t target, size_t k) {
+        aoc::ScopeTimer timer{"day1 k_sum"};
 
-            if ((i != j) && (numbers[i] + numbers[j] == 2020))
-                r1 = numbers[i] * numbers[j];
+        std::vector<uint64_t> sorted{};
+        sorted.reserve(numbers.size());
+        std::copy_if(numbers.begin(), numbers.end(), std::back_inserter(sorted), [target](uint64_t n) {
+            return n <= target;
+        });
+        std::sort(sorted.begin(), sorted.end());
 
-            for (size_t k = 0; k < numbers.size(); k++) {
-                if (numbers[k] >= 2020) continue;
+        size_t kept{0};
+        for (size_t i = 0; i < sorted.size(); i++) {
+            if (kept >= k && sorted[kept - k] == sorted[i]) continue;
+            sorted[kept++] = sorted[i];
+        }
+        sorted.resize(kept);
 
-                if ((k != j) && (k != i) && (numbers[i] + numbers[j] + numbers[k] ==  2020))
-                r2 = numbers[i] * numbers[j] * numbers[k];
-            }
+        std::vector<uint64_t> picked{};
+        picked.reserve(k);
+        if (!k_sum_sorted(sorted, target, k, picked)) return std::nullopt;
+        return picked;
+    }
+
+    static inline std::optional<aoc::BigUint> product_of_k_sum(std::span<const uint64_t> numbers, uint64_t target, size_t k) {
+        auto entries = k_sum(numbers, target, k);
+        if (!entries) {
+            fmt::print(std::cerr, "No {} entries add up to {}\n", k, target);
+            return std::nullopt;
         }
+        aoc::BigUint ret{1};
+        for (auto n : entries.value()) ret *= n;
+        return ret;
     }
 
-    fmt::print("{}\n", r1);
-    fmt::print("{}\n", r2);
+    // Options:
+    //   --target=N     sum the entries must add up to (default: 2020)
+    //   --part1-k=N    number of entries in part 1 (default: 2)
+    //   --part2-k=N    number of entries in part 2 (default: 3)
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params& params) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
+
+        auto target = params.get<uint64_t>("target", 2020);
+        auto part1_k = params.get<size_t>("part1-k", 2);
+        auto part2_k = params.get<size_t>("part2-k", 3);
+        if (!part1_k || !part2_k) {
+            fmt::print(std::cerr, "--part1-k and --part2-k must be at least 1\n");
+            return std::nullopt;
+        }
+
+        std::vector<uint64_t> numbers{};
+        if (auto rc = aoc::parse_ints(input.data(), '\n', numbers); rc.ec != std::errc()) {
+            fmt::print(std::cerr, "Invalid number on line {}\n", input.line_of(rc.ptr));
+            return std::nullopt;
+        }
+
+        auto r1 = product_of_k_sum(numbers, target, part1_k);
+        if (!r1) return std::nullopt;
+        answer.set_part1(r1.value());
 
-    return 0;
+        auto r2 = product_of_k_sum(numbers, target, part2_k);
+        if (!r2) return std::nullopt;
+        answer.set_part2(r2.value());
+
+        return answer;
+    }
 }
@@ -1,150 +1,420 @@
 #include <aoc.h>
 
-struct Position {
-    ssize_t x{0};
-    ssize_t y{0};
-};
-
-struct Map {
-    ssize_t width{0};
-    ssize_t height{0};
-    std::vector<char> data{};
-
-    static inline const std::array<Position, 8> directions{{
-        {-1, -1}, { 0,  -1}, { 1, -1},
-        {-1,  0}, { 1,   0},
-        {-1,  1}, { 0,   1}, { 1,  1}
-    }};
-
-    static inline std::optional<Map> read() {
-        std::string line{};
-        line.reserve(1024);
-        if (!std::getline(std::cin, line)) return std::nullopt;
-
-        Map res{};
-        res.width = line.size();
-        res.height = 1;
-        res.data.reserve(res.width * 1024);
-        res.data.insert(res.data.end(), line.begin(), line.end());
-
-        while (std::getline(std::cin, line)) {
-            if (line.size() != res.width) return std::nullopt;
+namespace day11 {
+    struct Position {
+        ssize_t x{0};
+        ssize_t y{0};
+    };
+
+    struct Map {
+        ssize_t width{0};
+        ssize_t height{0};
+        std::vector<char> data{};
+
+        static inline const std::array<Position, 8> directions{{
+            {-1, -1}, { 0,  -1}, { 1, -1},
+            {-1,  0}, { 1,   0},
+            {-1,  1}, { 0,   1}, { 1,  1}
+        }};
+
+        static inline std::optional<Map> read(aoc::Input& input) {
+            std::string_view line{};
+            if (!input.getline(line)) return std::nullopt;
+
+            Map res{};
+            res.width = line.size();
+            res.height = 1;
+            res.data.reserve(res.width * 1024);
             res.data.insert(res.data.end(), line.begin(), line.end());
-            res.height += 1;
+
+            while (input.getline(line)) {
+                if (line.size() != res.width) return std::nullopt;
+                res.data.insert(res.data.end(), line.begin(), line.end());
+                res.height += 1;
+            }
+
+            return res;
         }
 
-        return res;
-    }
+        inline bool position_valid(Position pos) const {
+            return
+                std::clamp(pos.x, ssize_t(0), width - 1) == pos.x &&
+                std::clamp(pos.y, ssize_t(0), height - 1) == pos.y;
+        }
 
-    inline bool position_valid(Position pos) const {
-        return
-            std::clamp(pos.x, ssize_t(0), width - 1) == pos.x &&
-            std::clamp(pos.y, ssize_t(0), height - 1) == pos.y;
-    }
+        inline Position advance(Position pos) const {
+            pos.x += 1;
+            if (pos.x >= width) {
+                pos.x = 0;
+                pos.y += 1;
+            }
+            return pos;
+        }
 
-    inline Position advance(Position pos) const {
-        pos.x += 1;
-        if (pos.x >= width) {
-            pos.x = 0;
-            pos.y += 1;
+        template <bool adjacent_only>
+        inline const std::vector<Position>& occupied_neighbours(Position pos, char occupied_val, char empty_val) const {
+            static std::vector<Position> ret{};
+            ret.reserve(8);
+            ret.clear();
+            for (auto delta : directions) {
+                Position p{pos.x + delta.x, pos.y + delta.y};
+                if constexpr (!adjacent_only) {
+                    while (position_valid(p) && (data.at(p.y * width + p.x) == empty_val))
+                        p = Position{p.x + delta.x, p.y + delta.y};
+                }
+                if (position_valid(p) && (data.at(p.y * width + p.x) == occupied_val))
+                    ret.push_back(p);
+            }
+            return ret;
         }
-        return pos;
-    }
 
-    template <bool adjacent_only>
-    inline const std::vector<Position>& occupied_neighbours(Position pos, char occupied_val, char empty_val) const {
-        static std::vector<Position> ret{};
-        ret.reserve(8);
-        ret.clear();
-        for (auto delta : directions) {
-            Position p{pos.x + delta.x, pos.y + delta.y};
-            if constexpr (!adjacent_only) {
-                while (position_valid(p) && (data.at(p.y * width + p.x) == empty_val))
-                    p = Position{p.x + delta.x, p.y + delta.y};
+        inline std::optional<char*> sample(Position pos) {
+            if (position_valid(pos))
+                return &data.at(pos.y * width + pos.x);
+            return std::nullopt;
+        }
+
+        inline std::optional<const char*> sample(Position pos) const {
+            if (position_valid(pos))
+                return &data.at(pos.y * width + pos.x);
+            return std::nullopt;
+        }
+    };
+
+    template <bool adjacent_only, size_t occupied_threshhold>
+    static inline size_t search_for_steady_state(const Map& map) {
+        aoc::ScopeTimer timer{adjacent_only ? "day11 steady state (adjacent)" : "day11 steady state (line of sight)"};
+        static auto generations = aoc::counter("day11 generations");
+
+        Map current{map};
+        Map next{map};
+        size_t occupied{0};
+        size_t changed{0};
+
+        while (true) {
+            Position pos{};
+            while (current.position_valid(pos)) {
+                auto current_value = *(current.sample(pos).value());
+                auto next_value_p = next.sample(pos).value();
+                const auto& neighbours = current.occupied_neighbours<adjacent_only>(pos, '#', '.');
+
+                switch (current_value) {
+                    case 'L': {
+                        if (neighbours.size()) {
+                            *next_value_p = 'L';
+                        } else {
+                            changed += 1;
+                            occupied += 1;
+                            *next_value_p = '#';
+                        }
+                        break;
+                    }
+                    case '#': {
+                        if (neighbours.size() < occupied_threshhold) {
+                            *next_value_p = '#';
+                        } else {
+                            changed += 1;
+                            occupied -= 1;
+                            *next_value_p = 'L';
+                        }
+                        break;
+                    }
+                    default: {
+                        break;
+                    }
+                }
+
+                pos = current.advance(pos);
             }
-            if (position_valid(p) && (data.at(p.y * width + p.x) == occupied_val))
-                ret.push_back(p);
+
+            ++generations;
+            if (!changed) break;
+
+            changed = 0;
+            std::swap(current, next);
         }
-        return ret;
-    }
 
-    inline std::optional<char*> sample(Position pos) {
-        if (position_valid(pos))
-            return &data.at(pos.y * width + pos.x);
-        return std::nullopt;
+        return occupied;
     }
 
-    inline std::optional<const char*> sample(Position pos) const {
-        if (position_valid(pos))
-            return &data.at(pos.y * width + pos.x);
-        return std::nullopt;
-    }
-};
-
-template <bool adjacent_only, size_t occupied_threshhold>
-static inline size_t search_for_steady_state(const Map& map) {
-    Map current{map};
-    Map next{map};
-    size_t occupied{0};
-    size_t changed{0};
-
-    while (true) {
-        Position pos{};
-        while (current.position_valid(pos)) {
-            auto current_value = *(current.sample(pos).value());
-            auto next_value_p = next.sample(pos).value();
-            const auto& neighbours = current.occupied_neighbours<adjacent_only>(pos, '#', '.');
-
-            switch (current_value) {
-                case 'L': {
-                    if (neighbours.size()) {
-                        *next_value_p = 'L';
-                    } else {
-                        changed += 1;
-                        occupied += 1;
-                        *next_value_p = '#';
-                    }
-                    break;
+    // Bit-parallel engine. Seats, floor and occupancy are bit planes with one
+    // bit per cell and rows padded to whole 64-bit words. Floor never changes,
+    // so the seat and floor planes are built once per map.
+    //
+    // For every direction, a plane holds "the first seat visible that way is
+    // occupied" for 64 cells at a time. The directions are:
+    // - Vertical and diagonal: occupancy propagates row by row through floor,
+    //   v(y) = shift(occ(y -/+ 1) | floor(y -/+ 1) & v(y -/+ 1)). The
+    //   downward directions are computed bottom-up in advance, the upward
+    //   ones on the fly.
+    // - Horizontal: a Kogge-Stone prefix scan over the row, with floor as
+    //   the propagate signal.
+    // With adjacent_only nothing propagates through floor, and every plane
+    // is just a shifted occupancy row.
+    //
+    // The 8 planes are summed bit-sliced and the seating rules applied to a
+    // whole word of cells at once.
+    class SeatPlanes {
+    public:
+        static inline SeatPlanes from_map(const Map& map) {
+            SeatPlanes ret{};
+            ret.width_ = size_t(map.width);
+            ret.height_ = size_t(map.height);
+            ret.words_ = (ret.width_ + 63) / 64;
+            ret.seats_.resize(ret.words_ * ret.height_);
+            ret.floor_.resize(ret.words_ * ret.height_);
+            ret.occupied_.resize(ret.words_ * ret.height_);
+            for (size_t y = 0; y < ret.height_; y++) {
+                for (size_t x = 0; x < ret.width_; x++) {
+                    auto c = map.data[y * ret.width_ + x];
+                    auto bit = uint64_t(1) << (x % 64);
+                    auto idx = y * ret.words_ + x / 64;
+                    if (c == 'L' || c == '#') ret.seats_[idx] |= bit;
+                    else ret.floor_[idx] |= bit;
+                    if (c == '#') ret.occupied_[idx] |= bit;
                 }
-                case '#': {
-                    if (neighbours.size() < occupied_threshhold) {
-                        *next_value_p = '#';
-                    } else {
-                        changed += 1;
-                        occupied -= 1;
-                        *next_value_p = 'L';
-                    }
-                    break;
+            }
+            return ret;
+        }
+
+        template <bool adjacent_only, size_t occupied_threshhold>
+        inline size_t steady_state() const {
+            aoc::ScopeTimer timer{adjacent_only ? "day11 SeatPlanes (adjacent)" : "day11 SeatPlanes (line of sight)"};
+            static auto generations = aoc::counter("day11 generations");
+
+            auto current = occupied_;
+            auto next = std::vector<uint64_t>(current.size());
+            auto below = std::array<std::vector<uint64_t>, 3>{};
+            for (auto& plane : below) plane.resize(current.size());
+            Scratch scratch(words_);
+
+            while (true) {
+                ++generations;
+                bool changed = step<adjacent_only, occupied_threshhold>(current, next, below, scratch);
+                std::swap(current, next);
+                if (!changed) break;
+            }
+
+            return std::accumulate(current.begin(), current.end(), size_t(0), [](size_t acc, uint64_t w) -> size_t {
+                return acc + size_t(std::popcount(w));
+            });
+        }
+
+    private:
+        size_t width_{0};
+        size_t height_{0};
+        size_t words_{0};
+        std::vector<uint64_t> seats_{};
+        std::vector<uint64_t> floor_{};
+        std::vector<uint64_t> occupied_{};
+
+        enum Direction { N, NW, NE, S, SW, SE, W, E, DirectionCount };
+
+        struct Scratch {
+            std::array<std::vector<uint64_t>, DirectionCount> planes;
+            std::vector<uint64_t> propagate;
+            std::vector<uint64_t> carry;
+            std::vector<uint64_t> tmp;
+
+            inline explicit Scratch(size_t words) : propagate(words), carry(words), tmp(words) {
+                for (auto& p : planes) p.resize(words);
+            }
+        };
+
+        // dst bit x = src bit (x - s), i.e. the row moved s cells east.
+        static inline void shift_east(const uint64_t* src, uint64_t* dst, size_t n, size_t s) noexcept {
+            auto ws = s / 64, bs = s % 64;
+            for (size_t k = n; k-- > 0;) {
+                uint64_t v{0};
+                if (k >= ws) {
+                    v = src[k - ws] << bs;
+                    if (bs && k > ws) v |= src[k - ws - 1] >> (64 - bs);
                 }
-                default: {
-                    break;
+                dst[k] = v;
+            }
+        }
+
+        // dst bit x = src bit (x + s), i.e. the row moved s cells west.
+        static inline void shift_west(const uint64_t* src, uint64_t* dst, size_t n, size_t s) noexcept {
+            auto ws = s / 64, bs = s % 64;
+            for (size_t k = 0; k < n; k++) {
+                uint64_t v{0};
+                if (k + ws < n) {
+                    v = src[k + ws] >> bs;
+                    if (bs && k + ws + 1 < n) v |= src[k + ws + 1] << (64 - bs);
                 }
+                dst[k] = v;
             }
+        }
+
+        // out(x) = occ(x -/+ 1) | pass(x -/+ 1) & out(x -/+ 1), as a parallel
+        // prefix: log2 of the longest floor run doubling steps per row.
+        template <bool adjacent_only, bool east>
+        inline void sweep_row(const uint64_t* occ, const uint64_t* pass, uint64_t* out, Scratch& scratch) const noexcept {
+            const auto shift = [this](const uint64_t* src, uint64_t* dst, size_t s) {
+                if constexpr (east) shift_west(src, dst, words_, s);
+                else shift_east(src, dst, words_, s);
+            };
+            shift(occ, out, 1);
+            if constexpr (adjacent_only) return;
 
-            pos = current.advance(pos);
+            auto* p = scratch.propagate.data();
+            auto* t = scratch.tmp.data();
+            shift(pass, p, 1);
+            for (size_t s = 1; s < width_; s *= 2) {
+                if (std::all_of(p, p + words_, [](uint64_t w) { return !w; })) break;
+                shift(out, t, s);
+                for (size_t k = 0; k < words_; k++) out[k] |= p[k] & t[k];
+                shift(p, t, s);
+                for (size_t k = 0; k < words_; k++) p[k] &= t[k];
+            }
         }
 
-        if (!changed) break;
+        // Moves the straight and the two diagonal planes of one vertical
+        // direction on to the next row over, given the occupancy and floor of
+        // the row they are leaving.
+        template <bool adjacent_only>
+        inline void advance_rows(const uint64_t* occ, const uint64_t* pass,
+            uint64_t* straight, uint64_t* looking_west, uint64_t* looking_east, Scratch& scratch) const noexcept
+        {
+            auto* t = scratch.carry.data();
+            for (size_t k = 0; k < words_; k++)
+                t[k] = adjacent_only ? occ[k] : occ[k] | (pass[k] & straight[k]);
+            std::copy_n(t, words_, straight);
 
-        changed = 0;
-        std::swap(current, next);
-    }
+            for (size_t k = 0; k < words_; k++)
+                t[k] = adjacent_only ? occ[k] : occ[k] | (pass[k] & looking_west[k]);
+            shift_east(t, looking_west, words_, 1);
 
-    return occupied;
-}
+            for (size_t k = 0; k < words_; k++)
+                t[k] = adjacent_only ? occ[k] : occ[k] | (pass[k] & looking_east[k]);
+            shift_west(t, looking_east, words_, 1);
+        }
+
+        template <bool adjacent_only, size_t occupied_threshhold>
+        inline bool step(const std::vector<uint64_t>& current, std::vector<uint64_t>& next,
+            std::array<std::vector<uint64_t>, 3>& below, Scratch& scratch) const noexcept
+        {
+            auto& planes = scratch.planes;
+
+            // Bottom-up: what row y sees looking S, SW and SE.
+            for (auto d : {S, SW, SE}) std::fill(planes[d].begin(), planes[d].end(), 0);
+            for (size_t y = height_; y-- > 0;) {
+                auto off = y * words_;
+                std::copy_n(planes[S].data(), words_, below[0].data() + off);
+                std::copy_n(planes[SW].data(), words_, below[1].data() + off);
+                std::copy_n(planes[SE].data(), words_, below[2].data() + off);
+                advance_rows<adjacent_only>(current.data() + off, floor_.data() + off,
+                    planes[S].data(), planes[SW].data(), planes[SE].data(), scratch);
+            }
+
+            // Top-down: N, NW and NE are carried along; E and W are per row.
+            bool changed{false};
+            for (auto d : {N, NW, NE}) std::fill(planes[d].begin(), planes[d].end(), 0);
+            for (size_t y = 0; y < height_; y++) {
+                auto off = y * words_;
+                const auto* occ = current.data() + off;
+                const auto* pass = floor_.data() + off;
+                sweep_row<adjacent_only, false>(occ, pass, planes[W].data(), scratch);
+                sweep_row<adjacent_only, true>(occ, pass, planes[E].data(), scratch);
+
+                for (size_t k = 0; k < words_; k++) {
+                    auto [c0, c1, c2, c3] = count8(
+                        planes[N][k], planes[NW][k], planes[NE][k],
+                        below[0][off + k], below[1][off + k], below[2][off + k],
+                        planes[W][k], planes[E][k]);
+                    auto none = ~(c0 | c1 | c2 | c3);
+                    uint64_t crowded{0};
+                    if constexpr (occupied_threshhold == 4) crowded = c2 | c3;
+                    else crowded = c3 | (c2 & (c0 | c1));
+                    auto o = occ[k];
+                    auto n = seats_[off + k] & ((~o & none) | (o & ~crowded));
+                    changed |= n != o;
+                    next[off + k] = n;
+                }
+
+                advance_rows<adjacent_only>(occ, pass, planes[N].data(), planes[NW].data(), planes[NE].data(), scratch);
+            }
+
+            return changed;
+        }
+
+        // Bit-sliced sum of eight one-bit inputs (0..8) with a carry-save
+        // adder tree; returns the four bit planes, least significant first.
+        static inline std::array<uint64_t, 4> count8(
+            uint64_t v0, uint64_t v1, uint64_t v2, uint64_t v3,
+            uint64_t v4, uint64_t v5, uint64_t v6, uint64_t v7) noexcept
+        {
+            const auto full_add = [](uint64_t a, uint64_t b, uint64_t c) -> std::pair<uint64_t, uint64_t> {
+                return {a ^ b ^ c, (a & b) | (a & c) | (b & c)};
+            };
+            auto [sa, ca] = full_add(v0, v1, v2);
+            auto [sb, cb] = full_add(v3, v4, v5);
+            auto sc = v6 ^ v7, cc = v6 & v7;
+            auto [b0, k1] = full_add(sa, sb, sc);
+            auto [t, k2] = full_add(ca, cb, cc);
+            auto b1 = t ^ k1, k3 = t & k1;
+            return {b0, b1, k2 ^ k3, k2 & k3};
+        }
+    };
 
-int main() {
-    Map seat_map{};
+    // Part 1 on the generic automaton: an empty seat fills up with no
+    // occupied neighbours (a birth at zero, restricted to seats by the mask)
+    // and stays occupied with fewer than four. Part 2 looks past floor
+    // tiles, which is not a fixed neighbourhood, so it always uses
+    // SeatPlanes.
+    static inline size_t steady_state_ca(const Map& map, aoc::ThreadPool* pool) {
+        using Seating = aoc::CellularAutomaton<2, aoc::ca::moore<2>(), aoc::ca::rule({0}, {0, 1, 2, 3})>;
 
-    if (auto r = Map::read(); !r) {
-        fmt::print(std::cerr, "Failed to load map!\n");
-        return 1;
-    } else {
-        seat_map = r.value();
+        Seating seating({size_t(map.width), size_t(map.height)}, pool);
+        for (size_t y = 0; y < size_t(map.height); y++) {
+            for (size_t x = 0; x < size_t(map.width); x++) {
+                auto c = map.data[y * size_t(map.width) + x];
+                if (c == 'L' || c == '#') seating.mask({x, y});
+                if (c == '#') seating.set({x, y});
+            }
+        }
+        seating.run_until_stable();
+        return seating.population();
     }
 
-    fmt::print("{}\n", search_for_steady_state<true, 4>(seat_map));
-    fmt::print("{}\n", search_for_steady_state<false, 5>(seat_map));
+    // Options:
+    //   --engine=bits|ca|scalar  simulation engine (default: bits); ca only
+    //                            covers part 1
+    //   --threads=N              worker threads of the ca engine (default: 1)
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params& params) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
 
-    return 0;
+        auto engine = params.get<std::string_view>("engine", "bits");
+        if (engine != "bits" && engine != "ca" && engine != "scalar") {
+            fmt::print(std::cerr, "Unknown engine '{}' (expected 'bits', 'ca' or 'scalar')\n", engine);
+            return std::nullopt;
+        }
+
+        Map seat_map{};
+        if (auto r = Map::read(input); !r) {
+            fmt::print(std::cerr, "Failed to load map!\n");
+            return std::nullopt;
+        } else {
+            seat_map = r.value();
+        }
+
+        if (engine == "scalar") {
+            answer.set_part1(search_for_steady_state<true, 4>(seat_map));
+            answer.set_part2(search_for_steady_state<false, 5>(seat_map));
+        } else if (engine == "ca") {
+            auto threads = params.get<size_t>("threads", 1);
+            std::optional<aoc::ThreadPool> pool{};
+            if (threads > 1) pool.emplace(threads);
+            answer.set_part1(steady_state_ca(seat_map, pool ? &pool.value() : nullptr));
+            answer.set_part2(SeatPlanes::from_map(seat_map).steady_state<false, 5>());
+        } else {
+            auto planes = SeatPlanes::from_map(seat_map);
+            answer.set_part1(planes.steady_state<true, 4>());
+            answer.set_part2(planes.steady_state<false, 5>());
+        }
+
+        return answer;
+    }
 }
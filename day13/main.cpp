@@ -1,56 +1,72 @@
 #include <aoc.h>
 
-struct Pair {
-    size_t idx{0};
-    size_t id{0};
-};
-std::ostream& operator<<(std::ostream& out, Pair p) {
-    return out << '{' << p.idx << ", " << p.id << '}';
-}
-
-int main() {
-    size_t timestamp{};
-    std::vector<Pair> ids{};
-    std::string line{};
-
-    if (!std::getline(std::cin, line)) return 1;
-    auto sv = aoc::trim(line);
-    auto rc = std::from_chars(sv.begin(), sv.end(), timestamp);
-    if (rc.ptr != sv.end()) {
-        fmt::print(std::cerr, "Failed to parse timestamp: '{}'\n", line);
-        return 1;
+namespace day13 {
+    struct Pair {
+        size_t idx{0};
+        size_t id{0};
+    };
+    std::ostream& operator<<(std::ostream& out, Pair p) {
+        return out << '{' << p.idx << ", " << p.id << '}';
     }
 
-    if (!std::getline(std::cin, line)) return 1;
-    size_t idx{0};
-    for (auto it : aoc::str_split(aoc::trim(line), ',')) {
-        size_t tmp{0};
-        rc = std::from_chars(it.begin(), it.end(), tmp);
-        if (rc.ptr == it.end()) ids.push_back({idx, tmp});
-        idx += 1;
-    }
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params&) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
+
+        size_t timestamp{};
+        std::vector<Pair> ids{};
+        std::string_view line{};
 
-    auto part1_id{std::numeric_limits<size_t>::max()};
-    auto part1_dif{std::numeric_limits<size_t>::max()};
-    for (auto [idx, id] : ids) {
-        auto div = timestamp / id;
-        auto dif = (div + 1) * id - timestamp;
-        if ((dif < part1_dif) || (dif == part1_dif && id < part1_id)) {
-            part1_id = id;
-            part1_dif = dif;
+        if (!input.getline(line)) return std::nullopt;
+        auto sv = aoc::trim(line);
+        auto rc = std::from_chars(sv.begin(), sv.end(), timestamp);
+        if (rc.ptr != sv.end()) {
+            fmt::print(std::cerr, "Failed to parse timestamp: '{}'\n", line);
+            return std::nullopt;
         }
-    }
-    fmt::print("{}\n", part1_id * part1_dif);
-
-    size_t inc{ids[0].id};
-    size_t n{0};
-    for (size_t idx = 0; idx < ids.size() - 1; idx++) {
-        auto current = ids[idx];
-        auto next = ids[idx + 1];
-        while ((n + next.idx) % next.id != 0) n += inc;
-        inc = inc * next.id;
-    }
-    fmt::print("{}\n", n);
 
-    return 0;
+        if (!input.getline(line)) return std::nullopt;
+        size_t idx{0};
+        for (auto it : aoc::split_view(aoc::trim(line), ',')) {
+            size_t tmp{0};
+            rc = std::from_chars(it.begin(), it.end(), tmp);
+            if (rc.ptr == it.end()) {
+                if (!tmp) {
+                    fmt::print(std::cerr, "Invalid bus ID 0 at position {}\n", idx + 1);
+                    return std::nullopt;
+                }
+                ids.push_back({idx, tmp});
+            }
+            idx += 1;
+        }
+        if (ids.empty()) {
+            fmt::print(std::cerr, "No bus IDs in the schedule\n");
+            return std::nullopt;
+        }
+
+        auto part1_id{std::numeric_limits<size_t>::max()};
+        auto part1_dif{std::numeric_limits<size_t>::max()};
+        for (auto [idx, id] : ids) {
+            auto div = timestamp / id;
+            auto dif = (div + 1) * id - timestamp;
+            if ((dif < part1_dif) || (dif == part1_dif && id < part1_id)) {
+                part1_id = id;
+                part1_dif = dif;
+            }
+        }
+        answer.set_part1(part1_id * part1_dif);
+
+        // Bus `id` departs at t + idx: t == -idx (mod id).
+        std::vector<aoc::Congruence> system{};
+        system.reserve(ids.size());
+        for (auto [idx, id] : ids) system.push_back({(id - idx % id) % id, id});
+        auto schedule = aoc::crt(system);
+        if (!schedule) {
+            fmt::print(std::cerr, "No timestamp satisfies the bus schedule\n");
+            return std::nullopt;
+        }
+        answer.set_part2(schedule->value);
+
+        return answer;
+    }
 }
@@ -1,62 +1,127 @@
 #include <aoc.h>
 
-struct Data {
-    uint32_t appearances{0};
-    uint32_t prev_turn{0};
-};
-std::ostream& operator<<(std::ostream& out, Data data) {
-    return out << '{' << data.appearances << ", " << data.prev_turn << '}';
-}
+namespace day15 {
+    struct Data {
+        uint32_t appearances{0};
+        uint32_t prev_turn{0};
+    };
+    std::ostream& operator<<(std::ostream& out, Data data) {
+        return out << '{' << data.appearances << ", " << data.prev_turn << '}';
+    }
 
-struct History {
-    std::map<uint32_t, Data> history_{};
-    Data* last_said{nullptr};
+    struct History {
+        aoc::FlatHashMap<uint32_t, Data> history_{};
+        Data* last_said{nullptr};
 
-    inline size_t size() const {
-        return history_.size();
-    }
+        inline size_t size() const {
+            return history_.size();
+        }
+
+        inline uint32_t add(uint32_t number, uint32_t turn) {
+            auto [it, inserted] = history_.insert({number, {}});
+            last_said = &it->second;
+            if (inserted) {
+                 *last_said = Data {
+                    .appearances = 1,
+                    .prev_turn = turn,
+                };
+                return 0;
+            }
+            std::swap(last_said->prev_turn, turn);
+            last_said->appearances += 1;
+            return last_said->prev_turn - turn;
+        }
+
+        inline uint32_t compute(uint32_t turn, uint32_t target_turn) {
+            aoc::ScopeTimer timer{"day15 History::compute"};
+            aoc::counter("day15 turns") += target_turn - turn;
+
+            auto next_number{last_said->appearances == 1 ? uint32_t(0) : turn - 1 - last_said->prev_turn};
+            while (turn < target_turn) {
+                auto tmp = add(next_number, turn);
+                next_number = tmp;
+                turn += 1;
+            }
+            return next_number;
+        }
+    };
+
+    // Every number spoken before turn N is smaller than N, so the turn each
+    // number was last said fits in a flat array indexed by the number itself
+    // (0 meaning "never said"). Each turn is then one load and one store,
+    // bounded only by memory latency.
+    inline std::optional<uint32_t> dense_game(const std::vector<uint32_t>& numbers, uint32_t target_turn, bool huge_pages) {
+        if (target_turn <= numbers.size()) return numbers[target_turn - 1];
+
+        aoc::ScopeTimer timer{"day15 dense_game"};
+        aoc::counter("day15 turns") += target_turn - numbers.size();
 
-    inline uint32_t add(uint32_t number, uint32_t turn) {
-        auto [it, inserted] = history_.insert({number, {}});
-        last_said = &it->second;
-        if (inserted) {
-             *last_said = Data {
-                .appearances = 1,
-                .prev_turn = turn,
-            };
-            return 0;
+        auto max_start = *std::max_element(numbers.begin(), numbers.end());
+        auto last_seen = aoc::PageArray<uint32_t>::allocate(std::max<size_t>(target_turn, size_t(max_start) + 1), huge_pages);
+        if (!last_seen) return std::nullopt;
+
+        auto* seen = last_seen->data();
+        uint32_t turn{1};
+        for (size_t i = 0; i + 1 < numbers.size(); i++) seen[numbers[i]] = turn++;
+        auto current = numbers.back();
+        for (; turn < target_turn; turn++) {
+            auto prev = std::exchange(seen[current], turn);
+            current = prev ? turn - prev : 0;
         }
-        std::swap(last_said->prev_turn, turn);
-        last_said->appearances += 1;
-        return last_said->prev_turn - turn;
+        return current;
     }
 
-    inline uint32_t compute(uint32_t turn, uint32_t target_turn) {
-        auto next_number{last_said->appearances == 1 ? uint32_t(0) : turn - 1 - last_said->prev_turn};
-        while (turn < target_turn) {
-            auto tmp = add(next_number, turn);
-            next_number = tmp;
+    inline std::optional<uint32_t> map_game(const std::vector<uint32_t>& numbers, uint32_t target_turn) {
+        if (target_turn <= numbers.size()) return numbers[target_turn - 1];
+
+        History history{};
+        uint32_t turn{1};
+        for (auto n : numbers) {
+            history.add(n, turn);
             turn += 1;
         }
-        return next_number;
-    }
-};
-
-int main() {
-    History history{};
-
-    std::string line{};
-    uint32_t turn{1};
-    if (!std::getline(std::cin, line)) return 1;
-    for (auto sv : aoc::str_split(line, ',')) {
-        auto rc = aoc::from_chars<uint32_t>(aoc::trim(sv));
-        if (!rc) return 2;
-        history.add(rc.value(), turn);
-        turn += 1;
+        return history.compute(turn, target_turn);
     }
 
-    fmt::print("{}\n", History(history).compute(turn, 2020));
-    fmt::print("{}\n", History(history).compute(turn, 30000000));
+    // Options:
+    //   --engine=dense|map  turn table to use (default: dense)
+    //   --turns=N           target turn of part 2 (default: 30000000)
+    //   --huge-pages        back the dense table with transparent huge pages
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params& params) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
+
+        auto engine = params.get<std::string_view>("engine", "dense");
+        auto turns = params.get<uint64_t>("turns", 30000000);
+        auto huge_pages = params.has("huge-pages");
+        if (engine != "dense" && engine != "map") {
+            fmt::print(std::cerr, "Unknown engine '{}' (expected 'dense' or 'map')\n", engine);
+            return std::nullopt;
+        }
+        if (!turns || turns > std::numeric_limits<uint32_t>::max()) {
+            fmt::print(std::cerr, "--turns must be between 1 and {}\n", std::numeric_limits<uint32_t>::max());
+            return std::nullopt;
+        }
 
-    return 0;
+        std::string_view line{};
+        std::vector<uint32_t> numbers{};
+        if (!input.getline(line)) return std::nullopt;
+        if (aoc::parse_ints(line, ',', numbers).ec != std::errc()) return std::nullopt;
+        if (numbers.empty()) return std::nullopt;
+
+        const auto play = [&](uint32_t target_turn) -> std::optional<uint32_t> {
+            if (engine == "map") return map_game(numbers, target_turn);
+            return dense_game(numbers, target_turn, huge_pages);
+        };
+
+        auto part1 = play(2020);
+        if (!part1) return std::nullopt;
+        answer.set_part1(part1.value());
+
+        auto part2 = play(uint32_t(turns));
+        if (!part2) return std::nullopt;
+        answer.set_part2(part2.value());
+
+        return answer;
+    }
 }
@@ -1,131 +1,358 @@
 #include <aoc.h>
 
-struct Position {
-    using val_type = uint64_t;
-    using comp_type = int16_t;
-
-    union {
-        val_type val;
-        struct {
-            comp_type x;
-            comp_type y;
-            comp_type z;
-            comp_type w;
+namespace day17 {
+    struct Position {
+        using val_type = uint64_t;
+        using comp_type = int16_t;
+
+        union {
+            val_type val;
+            struct {
+                comp_type x;
+                comp_type y;
+                comp_type z;
+                comp_type w;
+            };
         };
-    };
 
-    Position() : x(0), y(0), z(0), w(0) {}
-    Position(comp_type ix, comp_type iy, comp_type iz, comp_type iw = 0) : x(ix), y(iy), z(iz), w(iw) {}
-    Position(const Position&) = default;
-    Position(Position&&) = default;
-    Position& operator=(const Position&) = default;
+        Position() : x(0), y(0), z(0), w(0) {}
+        Position(comp_type ix, comp_type iy, comp_type iz, comp_type iw = 0) : x(ix), y(iy), z(iz), w(iw) {}
+        Position(const Position&) = default;
+        Position(Position&&) = default;
+        Position& operator=(const Position&) = default;
 
-    inline bool operator<(Position other) const { return val < other.val; }
-    inline bool operator==(Position other) { return val == other.val; }
+        inline bool operator<(Position other) const { return val < other.val; }
+        inline bool operator==(Position other) { return val == other.val; }
 
-    template <bool four_D>
-    inline void neighbours(std::vector<Position>& neigh) const {
-        neigh.clear();
-        if constexpr (four_D) {
-            for (comp_type dw = -1; dw < 2; dw++) {
+        template <bool four_D>
+        inline void neighbours(std::vector<Position>& neigh) const {
+            neigh.clear();
+            if constexpr (four_D) {
+                for (comp_type dw = -1; dw < 2; dw++) {
+                    for (comp_type dz = -1; dz < 2; dz++) {
+                        for (comp_type dy = -1; dy < 2; dy++) {
+                            for (comp_type dx = -1; dx < 2; dx++) {
+                                if (!dx && !dy && !dz && !dw) continue;
+                                neigh.emplace_back(x + dx, y + dy, z + dz, w + dw);
+                            }
+                        }
+                    }
+                }
+            } else {
                 for (comp_type dz = -1; dz < 2; dz++) {
                     for (comp_type dy = -1; dy < 2; dy++) {
                         for (comp_type dx = -1; dx < 2; dx++) {
-                            if (!dx && !dy && !dz && !dw) continue;
-                            neigh.emplace_back(x + dx, y + dy, z + dz, w + dw);
+                            if (!dx && !dy && !dz) continue;
+                            neigh.emplace_back(x + dx, y + dy, z + dz, 0);
                         }
                     }
                 }
             }
-        } else {
-            for (comp_type dz = -1; dz < 2; dz++) {
-                for (comp_type dy = -1; dy < 2; dy++) {
-                    for (comp_type dx = -1; dx < 2; dx++) {
-                        if (!dx && !dy && !dz) continue;
-                        neigh.emplace_back(x + dx, y + dy, z + dz, 0);
+        }
+    };
+    std::ostream& operator<<(std::ostream& out, Position pos) {
+        fmt::print(out, "{{{},{},{},{} {:#018x}}}", pos.x, pos.y, pos.z, pos.w, pos.val);
+        return out;
+    }
+
+    using Map = std::pmr::set<Position>;
+
+    template <bool four_D>
+    static inline void step(
+        const Map& map, Map& ret,
+        Position::comp_type& min_x, Position::comp_type& max_x,
+        Position::comp_type& min_y, Position::comp_type& max_y,
+        Position::comp_type& min_z, Position::comp_type& max_z,
+        Position::comp_type& min_w, Position::comp_type& max_w)
+    {
+        auto neigh_f = &Position::neighbours<four_D>;
+        std::vector<Position> neighbours{};
+
+        neighbours.reserve(80);
+
+        // The 3D simulation lives entirely in the w == 0 slice.
+        const int w_lo = four_D ? min_w - 1 : 0;
+        const int w_hi = four_D ? max_w + 1 : 0;
+        for (auto w = w_lo; w <= w_hi; w++) {
+            for (auto z = min_z - 1; z <= max_z + 1; z++) {
+                for (auto y = min_y - 1; y <= max_y + 1; y++) {
+                    for (auto x = min_x - 1; x <= max_x + 1; x++) {
+                        auto pos = Position(x, y, z, w);
+                        auto active = map.contains(pos);
+                        int count{0};
+                        (pos.*neigh_f)(neighbours);
+                        for (auto n : neighbours) count += map.contains(n);
+                        if ((active && (count == 2 || count == 3)) || (!active && count ==3))
+                            ret.insert(pos);
                     }
                 }
             }
         }
+
+        min_x -= 1; max_x += 1;
+        min_y -= 1; max_y += 1;
+        min_z -= 1; max_z += 1;
+        min_w -= 1; max_w += 1;
     }
-};
-std::ostream& operator<<(std::ostream& out, Position pos) {
-    fmt::print(out, "{{{},{},{},{} {:#018x}}}", pos.x, pos.y, pos.z, pos.w, pos.val);
-    return out;
-}
 
-template <bool four_D>
-static inline void step(
-    std::set<Position>& map,
-    Position::comp_type& min_x, Position::comp_type& max_x,
-    Position::comp_type& min_y, Position::comp_type& max_y,
-    Position::comp_type& min_z, Position::comp_type& max_z,
-    Position::comp_type& min_w, Position::comp_type& max_w)
-{
-    auto neigh_f = &Position::neighbours<four_D>;
-    std::vector<Position> neighbours{};
-
-    neighbours.reserve(80);
-
-    std::set<Position> ret{};
-    for (auto w = min_w - 1; w <= max_w + 1; w++) {
-        for (auto z = min_z - 1; z <= max_z + 1; z++) {
-            for (auto y = min_y - 1; y <= max_y + 1; y++) {
-                for (auto x = min_x - 1; x <= max_x + 1; x++) {
-                    auto pos = Position(x, y, z, w);
-                    auto active = map.contains(pos);
-                    int count{0};
-                    (pos.*neigh_f)(neighbours);
-                    for (auto n : neighbours) count += map.contains(n);
-                    if ((active && (count == 2 || count == 3)) || (!active && count ==3))
-                        ret.insert(pos);
+    // Only two generations are alive at any time. Each one gets its own arena,
+    // which is released wholesale once the generation has been superseded
+    // instead of freeing its set node by node.
+    template <bool four_D>
+    static inline size_t simulate(
+        const std::set<Position>& initial, size_t generations,
+        Position::comp_type min_x, Position::comp_type max_x,
+        Position::comp_type min_y, Position::comp_type max_y)
+    {
+        std::array<aoc::Arena, 2> arenas{};
+        std::array<Map, 2> maps{Map(initial.begin(), initial.end(), &arenas[0]), Map(&arenas[1])};
+        Position::comp_type min_z{0}, max_z{0}, min_w{0}, max_w{0};
+
+        for (size_t i = 0; i < generations; i++) {
+            auto& current = maps[i % 2];
+            auto& next = maps[(i + 1) % 2];
+            next.clear();
+            arenas[(i + 1) % 2].release();
+            step<four_D>(current, next, min_x, max_x, min_y, max_y, min_z, max_z, min_w, max_w);
+        }
+
+        return maps[generations % 2].size();
+    }
+
+    // Dense engine: one bit per cube, with every row along x packed into
+    // 64-bit words. A step sums the 3^D neighbourhood of a whole word of cells
+    // at once: each source row contributes its horizontal 3-sum (a full adder
+    // over the row and its two shifts), accumulated into bit-sliced counter
+    // planes. Counts include the cell itself, so a cell is alive next
+    // generation iff the sum is 3, or 4 and the cell is active.
+    //
+    // The grid is sized up front for `generations` steps plus one layer of
+    // padding in every direction, so neighbour rows never need bounds checks.
+    //
+    // With `fold` only z >= 0 (and w >= 0) is stored. The initial slice is
+    // z = w = 0, so the state stays mirror-symmetric around it. Before every
+    // step the z = 1 (w = 1) layer is copied into the z = -1 (w = -1) padding,
+    // and when counting, cubes off the mirror plane count twice per folded
+    // axis.
+    template <bool four_D>
+    class DenseGrid {
+        static constexpr const size_t counter_planes = four_D ? 7 : 5;
+
+    public:
+        static inline std::optional<DenseGrid> create(const std::set<Position>& initial, size_t width, size_t height, size_t generations, bool fold) {
+            DenseGrid ret(width, height, generations, fold);
+            auto size = ret.words_ * ret.ny_ * ret.nz_ * ret.nw_;
+            for (auto* grid : {&ret.current_, &ret.next_, &ret.ones_, &ret.twos_}) {
+                auto pages = aoc::PageArray<uint64_t>::allocate(size);
+                if (!pages) return std::nullopt;
+                *grid = std::move(pages.value());
+            }
+
+            auto origin = fold ? size_t(1) : generations + 1;
+            for (auto p : initial) {
+                auto x = size_t(p.x) + generations + 1;
+                auto y = size_t(p.y) + generations + 1;
+                ret.row(ret.current_, y, origin, four_D ? origin : 0)[x / 64] |= uint64_t(1) << (x % 64);
+            }
+            return ret;
+        }
+
+        inline size_t run() {
+            aoc::ScopeTimer timer{four_D ? "day17 DenseGrid<4D>::run" : "day17 DenseGrid<3D>::run"};
+            for (size_t g = 0; g < generations_; g++) {
+                if (fold_) reflect();
+                step(g + 1);
+                std::swap(current_, next_);
+            }
+            return population();
+        }
+
+    private:
+        bool fold_;
+        size_t generations_;
+        size_t height_;
+        size_t nx_, ny_, nz_, nw_;
+        size_t words_;
+        aoc::PageArray<uint64_t> current_{};
+        aoc::PageArray<uint64_t> next_{};
+        aoc::PageArray<uint64_t> ones_{};
+        aoc::PageArray<uint64_t> twos_{};
+
+        inline DenseGrid(size_t width, size_t height, size_t generations, bool fold)
+            : fold_(fold), generations_(generations), height_(height),
+              nx_(width + 2 * generations + 2), ny_(height + 2 * generations + 2),
+              nz_(fold ? generations + 3 : 2 * generations + 3), nw_(four_D ? nz_ : 1),
+              words_((nx_ + 63) / 64)
+        {}
+
+        inline size_t offset(size_t y, size_t z, size_t w) const noexcept {
+            return ((w * nz_ + z) * ny_ + y) * words_;
+        }
+
+        inline uint64_t* row(aoc::PageArray<uint64_t>& grid, size_t y, size_t z, size_t w) noexcept {
+            return grid.data() + offset(y, z, w);
+        }
+
+        // Slice range along z (or w) that can hold live cubes `radius`
+        // generations in.
+        inline std::pair<size_t, size_t> slice_range(size_t radius) const noexcept {
+            if (fold_) return {1, std::min(nz_ - 2, 1 + radius)};
+            return {generations_ + 1 - radius, generations_ + 1 + radius};
+        }
+
+        inline void reflect() noexcept {
+            auto slice = ny_ * words_;
+            for (size_t w = 0; w < nw_; w++)
+                std::copy_n(row(current_, 0, 2, w), slice, row(current_, 0, 0, w));
+            if constexpr (four_D)
+                std::copy_n(row(current_, 0, 0, 2), slice * nz_, row(current_, 0, 0, 0));
+        }
+
+        inline void step(size_t radius) noexcept {
+            auto [z_lo, z_hi] = slice_range(radius);
+            auto [w_lo, w_hi] = four_D ? slice_range(radius) : std::pair<size_t, size_t>(0, 0);
+            auto y_lo = generations_ + 1 - radius;
+            auto y_hi = generations_ + height_ + radius;
+            const size_t dw = four_D ? 1 : 0;
+
+            // Every row is a source for 3^(D-1) others, so its horizontal
+            // 3-sum (as a ones and a twos plane) is computed only once.
+            for (auto w = w_lo - dw; w <= w_hi + dw; w++) {
+                for (auto z = z_lo - 1; z <= z_hi + 1; z++) {
+                    for (auto y = y_lo - 1; y <= y_hi + 1; y++) {
+                        const auto* src = row(current_, y, z, w);
+                        auto* ones = row(ones_, y, z, w);
+                        auto* twos = row(twos_, y, z, w);
+                        for (size_t k = 0; k < words_; k++) {
+                            auto c = src[k];
+                            auto l = (c << 1) | (k ? src[k - 1] >> 63 : 0);
+                            auto r = (c >> 1) | (k + 1 < words_ ? src[k + 1] << 63 : 0);
+                            ones[k] = c ^ l ^ r;
+                            twos[k] = (c & l) | (c & r) | (l & r);
+                        }
+                    }
+                }
+            }
+
+            std::array<size_t, four_D ? 27 : 9> sources{};
+            for (auto w = w_lo; w <= w_hi; w++) {
+                for (auto z = z_lo; z <= z_hi; z++) {
+                    for (auto y = y_lo; y <= y_hi; y++) {
+                        size_t n{0};
+                        for (auto sw = w - dw; sw <= w + dw; sw++)
+                            for (auto sz = z - 1; sz <= z + 1; sz++)
+                                for (auto sy = y - 1; sy <= y + 1; sy++)
+                                    sources[n++] = offset(sy, sz, sw);
+
+                        const auto* self = row(current_, y, z, w);
+                        auto* dst = row(next_, y, z, w);
+                        for (size_t k = 0; k < words_; k++) {
+                            aoc::ca::PlaneSum<counter_planes, 128> sum;
+                            for (auto src : sources) {
+                                sum.add(ones_[src + k], 0);
+                                sum.add(twos_[src + k], 1);
+                            }
+                            auto planes = sum.reduce();
+                            uint64_t high{0};
+                            for (size_t p = 3; p < counter_planes; p++) high |= planes[p];
+                            auto three = planes[0] & planes[1] & ~planes[2];
+                            auto four = ~planes[0] & ~planes[1] & planes[2];
+                            dst[k] = ~high & (three | (self[k] & four));
+                        }
+                    }
                 }
             }
         }
-    }
 
-    map = std::move(ret);
-    min_x -= 1; max_x += 1;
-    min_y -= 1; max_y += 1;
-    min_z -= 1; max_z += 1;
-    min_w -= 1; max_w += 1;
-}
+        inline size_t population() noexcept {
+            size_t ret{0};
+            for (size_t w = four_D ? 1 : 0; w < (four_D ? nw_ - 1 : 1); w++) {
+                for (size_t z = 1; z < nz_ - 1; z++) {
+                    size_t weight = (fold_ && z > 1 ? 2 : 1) * (fold_ && four_D && w > 1 ? 2 : 1);
+                    const auto* slice = row(current_, 0, z, w);
+                    size_t count{0};
+                    for (size_t i = 0; i < ny_ * words_; i++) count += size_t(std::popcount(slice[i]));
+                    ret += count * weight;
+                }
+            }
+            return ret;
+        }
+    };
+
+    template <bool four_D>
+    static inline size_t simulate_ca(const std::set<Position>& initial, size_t width, size_t height, size_t generations, aoc::ThreadPool* pool) {
+        static constexpr const size_t D = four_D ? 4 : 3;
+        using Cubes = aoc::CellularAutomaton<D, aoc::ca::moore<D>(), aoc::ca::rule({3}, {2, 3})>;
 
-int main() {
-    std::set<Position> map{};
-
-    std::string line{};
-    Position::comp_type x{0}, y{0}, z{0};
-    Position::comp_type min_x{0}, min_y{0};
-    Position::comp_type max_x{0}, max_y{0};
-    while (std::getline(std::cin, line)) {
-        auto sv = aoc::trim(line);
-        for (x = 0; x < sv.size(); x++) {
-            if (sv[x] != '#') continue;
-            map.insert(Position(x, y, z));
-            max_x = std::max(x, max_x);
+        auto g = generations;
+        auto extents = typename Cubes::Coords{width + 2 * g, height + 2 * g, 2 * g + 1};
+        if constexpr (four_D) extents[3] = 2 * g + 1;
+        Cubes cubes(extents, pool);
+        for (auto p : initial) {
+            auto c = typename Cubes::Coords{size_t(p.x) + g, size_t(p.y) + g, g};
+            if constexpr (four_D) c[3] = g;
+            cubes.set(c);
         }
-        y += 1;
-        max_y = y;
+        cubes.run(generations);
+        return cubes.population();
     }
 
-    {
-        auto tmp_map = map;
-        Position::comp_type x1{min_x}, x2{max_x}, y1{min_y}, y2{max_y}, z1{0}, z2{0};
-        for (size_t i = 0; i < 6; i++) {
-            Position::comp_type w1{1}, w2{-1};
-            step<false>(tmp_map, x1, x2, y1, y2, z1, z2, w1, w2);
+    // Options:
+    //   --engine=folded|dense|ca|set  simulation engine (default: folded)
+    //   --generations=N               number of cycles to simulate (default: 6)
+    //   --threads=N                   worker threads of the ca engine (default: 1)
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params& params) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
+
+        auto engine = params.get<std::string_view>("engine", "folded");
+        auto generations = params.get<size_t>("generations", 6);
+        if (engine != "folded" && engine != "dense" && engine != "ca" && engine != "set") {
+            fmt::print(std::cerr, "Unknown engine '{}' (expected 'folded', 'dense', 'ca' or 'set')\n", engine);
+            return std::nullopt;
         }
-        fmt::print("{}\n", tmp_map.size());
-    }
 
-    {
-        auto tmp_map = map;
-        Position::comp_type  x1{min_x}, x2{max_x}, y1{min_y}, y2{max_y}, z1{0}, z2{0}, w1{0}, w2{0};
-        for (size_t i = 0; i < 6; i++)
-            step<true>(tmp_map, x1, x2, y1, y2, z1, z2, w1, w2);
-        fmt::print("{}\n", tmp_map.size());
-    }
+        std::set<Position> map{};
 
-    return 0;
+        std::string_view line{};
+        Position::comp_type x{0}, y{0}, z{0};
+        Position::comp_type min_x{0}, min_y{0};
+        Position::comp_type max_x{0}, max_y{0};
+        while (input.getline(line)) {
+            auto sv = aoc::trim(line);
+            for (x = 0; x < sv.size(); x++) {
+                if (sv[x] != '#') continue;
+                map.insert(Position(x, y, z));
+                max_x = std::max(x, max_x);
+            }
+            y += 1;
+            max_y = y;
+        }
+
+        auto width = size_t(max_x) + 1;
+        auto height = size_t(max_y);
+        if (engine == "set") {
+            answer.set_part1(simulate<false>(map, generations, min_x, max_x, min_y, max_y));
+            answer.set_part2(simulate<true>(map, generations, min_x, max_x, min_y, max_y));
+        } else if (engine == "ca") {
+            auto threads = params.get<size_t>("threads", 1);
+            std::optional<aoc::ThreadPool> pool{};
+            if (threads > 1) pool.emplace(threads);
+            auto* p = pool ? &pool.value() : nullptr;
+            answer.set_part1(simulate_ca<false>(map, width, height, generations, p));
+            answer.set_part2(simulate_ca<true>(map, width, height, generations, p));
+        } else {
+            auto fold = engine == "folded";
+            auto grid_3d = DenseGrid<false>::create(map, width, height, generations, fold);
+            if (!grid_3d) return std::nullopt;
+            answer.set_part1(grid_3d->run());
+            grid_3d.reset();
+
+            auto grid_4d = DenseGrid<true>::create(map, width, height, generations, fold);
+            if (!grid_4d) return std::nullopt;
+            answer.set_part2(grid_4d->run());
+        }
+
+        return answer;
+    }
 }
@@ -1,146 +1,159 @@
 #include <aoc.h>
 
-inline std::string_view extract_term(std::string_view& expr) {
-    auto* start = expr.begin();
-    auto* end = expr.end();
-    while ((start < end) && std::isspace(*start)) start++;
-    if (start >= end) {
-        expr = std::string_view(end, end);
-        return expr;
-    }
-    if (std::isdigit(*start)) {
-        auto* tmp = start;
-        while ((tmp < end) &&std::isdigit(*tmp)) tmp++;
-        expr = std::string_view(tmp, end);
-        return std::string_view(start, tmp);
-    } else if (*start == '(') {
-        size_t count = 1;
-        auto* tmp = start + 1;
-        while (tmp < end) {
-            switch (*tmp) {
-                case '(': {
-                    count += 1;
-                    break;
-                }
-                case ')': {
-                    if (!count) {
-                        expr = std::string_view(end, end);
-                        return expr;
+namespace day18 {
+    inline std::string_view extract_term(std::string_view& expr) {
+        auto* start = expr.begin();
+        auto* end = expr.end();
+        while ((start < end) && aoc::scan::is_space(*start)) start++;
+        if (start >= end) {
+            expr = std::string_view(end, end);
+            return expr;
+        }
+        if (std::isdigit(*start)) {
+            auto* tmp = start;
+            while ((tmp < end) &&std::isdigit(*tmp)) tmp++;
+            expr = std::string_view(tmp, end);
+            return std::string_view(start, tmp);
+        } else if (*start == '(') {
+            size_t count = 1;
+            auto* tmp = start + 1;
+            while (tmp < end) {
+                switch (*tmp) {
+                    case '(': {
+                        count += 1;
+                        break;
                     }
-                    count -= 1;
-                    if (!count) {
-                        expr = std::string_view(tmp + 1, end);
-                        return std::string_view(start, tmp + 1);
+                    case ')': {
+                        if (!count) {
+                            expr = std::string_view(end, end);
+                            return expr;
+                        }
+                        count -= 1;
+                        if (!count) {
+                            expr = std::string_view(tmp + 1, end);
+                            return std::string_view(start, tmp + 1);
+                        }
+                        break;
+                    }
+                    default: {
+                        break;
                     }
-                    break;
-                }
-                default: {
-                    break;
                 }
+                tmp++;
             }
-            tmp++;
         }
+        expr = std::string_view(end, end);
+        return expr;
     }
-    expr = std::string_view(end, end);
-    return expr;
-}
 
-inline std::string_view extract_op(std::string_view& expr) {
-    auto* start = expr.begin();
-    auto* end = expr.end();
-    while ((start < end) && std::isspace(*start)) start++;
-    if (start >= end) {
+    inline std::string_view extract_op(std::string_view& expr) {
+        auto* start = expr.begin();
+        auto* end = expr.end();
+        while ((start < end) && aoc::scan::is_space(*start)) start++;
+        if (start >= end) {
+            expr = std::string_view(end, end);
+            return expr;
+        }
+        if (*start == '+' || *start == '*') {
+            expr = std::string_view(start + 1, end);
+            return std::string_view(start, start + 1);
+        }
         expr = std::string_view(end, end);
         return expr;
     }
-    if (*start == '+' || *start == '*') {
-        expr = std::string_view(start + 1, end);
-        return std::string_view(start, start + 1);
-    }
-    expr = std::string_view(end, end);
-    return expr;
-}
 
-inline void split(std::string_view expr, std::vector<std::string_view>& parts) {
-    parts.clear();
-    auto term = extract_term(expr);
-    parts.push_back(term);
-    while (!expr.empty()) {
-        parts.push_back(extract_op(expr));
-        parts.push_back(extract_term(expr));
-    }
-}
+    // Sub-expressions allocate from the same resource as their parent, so one
+    // arena per input line covers the whole recursive evaluation.
+    using Parts = std::pmr::vector<std::string_view>;
 
-inline size_t p1_eval(const std::vector<std::string_view>& parts) {
-    static const auto do_eval = [](std::string_view sv) -> size_t {
-        if (sv[0] == '(') {
-            std::vector<std::string_view> parts{};
-            sv.remove_prefix(1);
-            sv.remove_suffix(1);
-            split(sv, parts);
-            return p1_eval(parts);
+    inline void split(std::string_view expr, Parts& parts) {
+        parts.clear();
+        auto term = extract_term(expr);
+        parts.push_back(term);
+        while (!expr.empty()) {
+            parts.push_back(extract_op(expr));
+            parts.push_back(extract_term(expr));
         }
-        return aoc::from_chars<size_t>(sv).value();
-    };
-    auto ret{do_eval(parts[0])};
-    for (size_t i = 1; i < parts.size() - 1; i += 2) {
-        auto rhs{do_eval(parts[i + 1])};
-        switch (parts[i][0]) {
-            case '+': {
-                ret += rhs;
-                break;
+    }
+
+    inline size_t p1_eval(const Parts& parts) {
+        const auto do_eval = [alloc = parts.get_allocator()](std::string_view sv) -> size_t {
+            if (sv[0] == '(') {
+                Parts parts(alloc);
+                sv.remove_prefix(1);
+                sv.remove_suffix(1);
+                split(sv, parts);
+                return p1_eval(parts);
             }
-            case '*': {
-                ret *= rhs;
-                break;
+            return aoc::from_chars<size_t>(sv).value();
+        };
+        auto ret{do_eval(parts[0])};
+        for (size_t i = 1; i < parts.size() - 1; i += 2) {
+            auto rhs{do_eval(parts[i + 1])};
+            switch (parts[i][0]) {
+                case '+': {
+                    ret += rhs;
+                    break;
+                }
+                case '*': {
+                    ret *= rhs;
+                    break;
+                }
             }
         }
+        return ret;
     }
-    return ret;
-}
 
-inline size_t p2_eval(const std::vector<std::string_view>& parts) {
-    static const auto do_eval = [](std::string_view sv) -> size_t {
-        if (sv[0] == '(') {
-            std::vector<std::string_view> parts{};
-            sv.remove_prefix(1);
-            sv.remove_suffix(1);
-            split(sv, parts);
-            return p2_eval(parts);
+    inline size_t p2_eval(const Parts& parts) {
+        const auto do_eval = [alloc = parts.get_allocator()](std::string_view sv) -> size_t {
+            if (sv[0] == '(') {
+                Parts parts(alloc);
+                sv.remove_prefix(1);
+                sv.remove_suffix(1);
+                split(sv, parts);
+                return p2_eval(parts);
+            }
+            return aoc::from_chars<size_t>(sv).value();
+        };
+        std::pmr::vector<size_t> values(parts.get_allocator());
+        values.reserve(parts.size() + 1);
+        for (size_t i = 0; i < parts.size(); i += 2) {
+            values.push_back(do_eval(parts[i]));
+            values.push_back(1);
         }
-        return aoc::from_chars<size_t>(sv).value();
-    };
-    std::vector<size_t> values{};
-    for (size_t i = 0; i < parts.size(); i += 2) {
-        values.push_back(do_eval(parts[i]));
-        values.push_back(1);
-    }
-    for (size_t i = 1; i < parts.size(); i += 2) {
-        if (parts[i][0] != '+') continue;
-        values[i + 1] += values[i - 1];
-        values[i - 1] = 1;
+        for (size_t i = 1; i < parts.size(); i += 2) {
+            if (parts[i][0] != '+') continue;
+            values[i + 1] += values[i - 1];
+            values[i - 1] = 1;
+        }
+        return std::accumulate(values.begin(), values.end(), size_t(1), [](size_t acc, size_t v) -> size_t {
+            return acc * v;
+        });
     }
-    return std::accumulate(values.begin(), values.end(), size_t(1), [](size_t acc, size_t v) -> size_t {
-        return acc * v;
-    });
-}
 
-int main() {
-    std::vector<std::string_view> parts{};
-    std::string line{};
-    size_t part1{0};
-    size_t part2{0};
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params&) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
 
-    parts.reserve(128);
+        aoc::Arena arena{};
+        std::string_view line{};
+        size_t part1{0};
+        size_t part2{0};
 
-    while (std::getline(std::cin, line)) {
-        split(aoc::trim(line), parts);
-        part1 += p1_eval(parts);
-        part2 += p2_eval(parts);
-    }
+        while (input.getline(line)) {
+            {
+                Parts parts(&arena);
+                parts.reserve(128);
+                split(aoc::trim(line), parts);
+                part1 += p1_eval(parts);
+                part2 += p2_eval(parts);
+            }
+            arena.release();
+        }
 
-    fmt::print("{}\n", part1);
-    fmt::print("{}\n", part2);
+        answer.set_part1(part1);
+        answer.set_part2(part2);
 
-    return 0;
+        return answer;
+    }
 }
@@ -1,116 +1,217 @@
 #include <aoc.h>
 
-static inline bool parse_rules(const std::vector<std::string>& raw_rules, std::map<std::string_view, std::string_view>& rules) {
-    static const std::regex complex_re("([^:\\s]+)\\s*:\\s*([^\"]+)");
-    static const std::regex simple_re("([^:\\s]+)\\s*:\\s*(\"[^\"]+\")");
-    for (auto& raw : raw_rules) {
-        auto sv = aoc::to_sv(raw);
-        if (auto m = std::cmatch{}; std::regex_match(sv.begin(), sv.end(), m, complex_re))
-            rules.insert_or_assign(aoc::to_sv(m[1]), aoc::to_sv(m[2]));
-        else if (auto m = std::cmatch{}; std::regex_match(sv.begin(), sv.end(), m, simple_re))
-            rules.insert_or_assign(aoc::to_sv(m[1]), aoc::to_sv(m[2]));
-        else {
-            fmt::print(std::cerr, "Failed to parse rule: '{}'\n", raw);
-            return false;
+namespace day19 {
+    static inline bool parse_rules(const std::vector<std::string_view>& raw_rules, std::map<std::string_view, std::string_view>& rules) {
+        for (auto sv : raw_rules) {
+            if (auto m = aoc::match<"([^:\\s]+)\\s*:\\s*([^\"]+)">(sv))
+                rules.insert_or_assign(m->at(0), m->at(1));
+            else if (auto m = aoc::match<"([^:\\s]+)\\s*:\\s*(\"[^\"]+\")">(sv))
+                rules.insert_or_assign(m->at(0), m->at(1));
+            else {
+                fmt::print(std::cerr, "Failed to parse rule: '{}'\n", sv);
+                return false;
+            }
         }
+        return true;
     }
-    return true;
-}
 
-static inline std::optional<std::string> rule_to_re(const std::map<std::string_view, std::string_view>& rules, std::string_view id, size_t level = 0) {
-    static std::map<std::string_view, std::string> resolved_rules{};
-
-    auto it = rules.find(id);
-    if (it == rules.end()) return std::nullopt;
-
-    std::string ret{};
-    auto v = it->second;
-    if (v.empty()) return ret;
-
-    if (v[0] == '"') {
-        v.remove_prefix(1);
-        v.remove_suffix(1);
-        ret = std::string(v);
-    } else {
-        static const std::regex space_re("\\s+");
-        static const std::regex pipe_re("\\s*\\|\\s*");
-        auto opts = aoc::str_split(v, pipe_re);
-        if (opts.size() > 1) ret.append("(?:");
-        for (size_t i = 0; i < opts.size(); i++) {
-            auto opt = opts[i];
-            auto ids = aoc::str_split(opt, space_re);
-            for (auto _id : ids) {
-                bool recurse{_id.ends_with('+')};
-                if (recurse) _id.remove_suffix(1);
-                if (auto rit = resolved_rules.find(_id); rit != resolved_rules.end()) {
-                    ret.append(rit->second);
+    // The rules reachable from a start rule, with ids interned to dense
+    // integers. A rule is either a literal or a list of alternatives, each a
+    // sequence of rule ids; rules may refer to themselves (or each other)
+    // in any position.
+    //
+    // matches() is memoised recursive descent over sets of positions: the
+    // entry for (rule, pos) is the set of every position where a match of
+    // `rule` starting at `pos` can end, kept as a bitset over the message.
+    // Sets make backtracking unnecessary, and memoisation makes every entry
+    // a one-time cost. A rule that reaches itself without consuming input
+    // (left recursion) finds its own entry still in progress and uses what
+    // it holds so far; when that happens the message is matched again with
+    // the previous results as seeds until nothing grows, which is the least
+    // fixpoint of the grammar. Rules that always consume input before
+    // recursing, like 8 and 11 in part 2, need just the one pass.
+    class Grammar {
+    public:
+        static inline std::optional<Grammar> compile(const std::map<std::string_view, std::string_view>& rules, std::string_view start) {
+            Grammar ret{};
+            aoc::FlatHashMap<std::string_view, uint32_t> ids{};
+            std::vector<std::string_view> names{};
+            const auto intern = [&](std::string_view name) -> uint32_t {
+                auto [it, inserted] = ids.try_emplace(name, uint32_t(names.size()));
+                if (inserted) names.push_back(name);
+                return it->second;
+            };
+
+            intern(start);
+            for (size_t id = 0; id < names.size(); id++) {
+                auto it = rules.find(names[id]);
+                if (it == rules.end()) {
+                    fmt::print(std::cerr, "Reference to undefined rule '{}'\n", names[id]);
+                    return std::nullopt;
+                }
+
+                Rule rule{};
+                auto v = aoc::trim(it->second);
+                if (!v.empty() && v[0] == '"') {
+                    v.remove_prefix(1);
+                    v.remove_suffix(1);
+                    rule.literal = v;
+                    rule.terminal = true;
                 } else {
-                    auto r = rule_to_re(rules, _id, level + 1);
-                    if (!r) return std::nullopt;
-                    ret.append(r.value());
+                    for (auto alt : aoc::split_view(v, '|')) {
+                        auto& seq = rule.alternatives.emplace_back();
+                        for (auto sym : aoc::split_view(aoc::trim(alt), ' ')) {
+                            if (sym.empty()) continue;
+                            seq.push_back(intern(sym));
+                        }
+                    }
                 }
-                if (recurse) ret.append("+");
+                ret.rules_.push_back(std::move(rule));
             }
-            if (i < opts.size() - 1) ret.append("|");
+            return ret;
         }
-        if (opts.size() > 1) ret.append(")");
-    }
 
-    if (!level) {
-        resolved_rules.clear();
-        ret = fmt::format("^{}$", ret);
-    } else {
-        resolved_rules.insert({id, ret});
-    }
+        inline bool matches(std::string_view message) {
+            message_ = message;
+            positions_ = message.size() + 1;
+            words_ = (positions_ + 63) / 64;
+            ends_.assign(rules_.size() * positions_ * words_, 0);
+            state_.resize(rules_.size() * positions_);
 
-    return ret;
-}
+            bool more{true};
+            while (more) {
+                std::fill(state_.begin(), state_.end(), State::unvisited);
+                recursed_ = false;
+                changed_ = false;
+                ends(0, 0);
+                more = recursed_ && changed_;
+            }
+            auto last = message.size();
+            return (ends_[last / 64] >> (last % 64)) & 1;
+        }
 
-int main() {
-    std::vector<std::string> raw_rules{};
-    std::map<std::string_view, std::string_view> rules{};
-    std::string line{};
-    std::regex part1_re{};
-    std::regex part2_re{};
+    private:
+        enum class State : uint8_t {
+            unvisited,
+            in_progress,
+            done,
+        };
 
-    while (std::getline(std::cin, line)) {
-        if (aoc::trim(line).empty()) break;
-        raw_rules.push_back(line);
-    }
+        struct Rule {
+            bool terminal{false};
+            std::string_view literal{};
+            std::vector<std::vector<uint32_t>> alternatives{};
+        };
 
-    if (!parse_rules(raw_rules, rules)) return 1;
-    if (auto r = rule_to_re(rules, "0"); r) {
-        part1_re = std::regex(r.value());
-    } else {
-        fmt::print(std::cerr, "Failed to generate string for part 1\n");
-        return 1;
-    }
+        std::vector<Rule> rules_{};
 
-    rules.clear();
-    raw_rules.push_back("8: 42+");
-    raw_rules.push_back("11: 42 31 | 42 9000 31");
-    for (size_t id = 9000; id < 9004; id++)
-        raw_rules.push_back(fmt::format("{}: 42 31 | 42 {} 31", id, id + 1));
-    raw_rules.push_back("9004: 42 31");
-    if (!parse_rules(raw_rules, rules)) return 1;
-    if (auto r = rule_to_re(rules, "0"); r) {
-        part2_re = std::regex(r.value());
-    } else {
-        fmt::print(std::cerr, "Failed to generate string for part 2\n");
-        return 1;
-    }
+        std::string_view message_{};
+        size_t positions_{0};
+        size_t words_{0};
+        std::vector<uint64_t> ends_{};
+        std::vector<State> state_{};
+        bool recursed_{false};
+        bool changed_{false};
+
+        inline const uint64_t* ends(uint32_t id, size_t pos) {
+            auto entry = size_t(id) * positions_ + pos;
+            auto* out = ends_.data() + entry * words_;
+            if (state_[entry] == State::done) return out;
+            if (state_[entry] == State::in_progress) {
+                recursed_ = true;
+                return out;
+            }
+            state_[entry] = State::in_progress;
+
+            // acc | cur | next
+            std::array<uint64_t, 3 * 4> local{};
+            std::vector<uint64_t> heap{};
+            if (words_ > 4) heap.resize(3 * words_);
+            auto* acc = words_ > 4 ? heap.data() : local.data();
+            auto* cur = acc + words_;
+            auto* next = cur + words_;
+            std::fill_n(acc, words_, 0);
 
-    size_t part1{0};
-    size_t part2{0};
-    while (std::getline(std::cin, line)) {
-        auto sv = aoc::trim(line);
-        if (auto m = std::cmatch{}; std::regex_match(sv.begin(), sv.end(), m, part1_re))
-            part1 += 1;
-        if (auto m = std::cmatch{}; std::regex_match(sv.begin(), sv.end(), m, part2_re))
-            part2 += 1;
+            const auto& rule = rules_[id];
+            if (rule.terminal) {
+                if (message_.substr(pos).starts_with(rule.literal)) {
+                    auto end = pos + rule.literal.size();
+                    acc[end / 64] |= uint64_t(1) << (end % 64);
+                }
+            } else {
+                for (const auto& seq : rule.alternatives) {
+                    std::fill_n(cur, words_, 0);
+                    cur[pos / 64] |= uint64_t(1) << (pos % 64);
+                    bool any{true};
+                    for (auto sym : seq) {
+                        std::fill_n(next, words_, 0);
+                        any = false;
+                        for (size_t w = 0; w < words_; w++) {
+                            for (auto bits = cur[w]; bits; bits &= bits - 1) {
+                                auto* sub = ends(sym, w * 64 + size_t(std::countr_zero(bits)));
+                                for (size_t k = 0; k < words_; k++) {
+                                    next[k] |= sub[k];
+                                    any |= sub[k] != 0;
+                                }
+                            }
+                        }
+                        std::swap(cur, next);
+                        if (!any) break;
+                    }
+                    if (!any) continue;
+                    for (size_t k = 0; k < words_; k++) acc[k] |= cur[k];
+                }
+            }
+
+            // `out` can be read (as a seed) by the calls above, so it is
+            // only written once the entry is complete.
+            if (!std::equal(acc, acc + words_, out)) {
+                std::copy_n(acc, words_, out);
+                changed_ = true;
+            }
+            state_[entry] = State::done;
+            return out;
+        }
+    };
+
+    static inline std::optional<Grammar> compile(std::map<std::string_view, std::string_view>& rules, size_t part) {
+        auto grammar = Grammar::compile(rules, "0");
+        if (!grammar) fmt::print(std::cerr, "Failed to compile the rules for part {}\n", part);
+        return grammar;
     }
-    fmt::print("{}\n", part1);
-    fmt::print("{}\n", part2);
 
-    return 0;
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params&) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
+
+        std::vector<std::string_view> raw_rules{};
+        std::map<std::string_view, std::string_view> rules{};
+        std::string_view line{};
+
+        while (input.getline(line)) {
+            if (aoc::trim(line).empty()) break;
+            raw_rules.push_back(line);
+        }
+
+        if (!parse_rules(raw_rules, rules)) return std::nullopt;
+        auto part1_grammar = compile(rules, 1);
+        if (!part1_grammar) return std::nullopt;
+
+        rules.insert_or_assign("8", "42 | 42 8");
+        rules.insert_or_assign("11", "42 31 | 42 11 31");
+        auto part2_grammar = compile(rules, 2);
+        if (!part2_grammar) return std::nullopt;
+
+        size_t part1{0};
+        size_t part2{0};
+        while (input.getline(line)) {
+            auto sv = aoc::trim(line);
+            if (part1_grammar->matches(sv)) part1 += 1;
+            if (part2_grammar->matches(sv)) part2 += 1;
+        }
+        answer.set_part1(part1);
+        answer.set_part2(part2);
+
+        return answer;
+    }
 }
@@ -1,113 +1,126 @@
 #include <aoc.h>
 
-template <typename T>
-static inline std::vector<T> sublist(const std::vector<T>& l, size_t n) {
-    return std::vector<T>(l.begin(), aoc::advance(l.begin(), n));
-}
-
-template <typename T>
-static inline T score(const std::vector<T>& l) {
-    T ret{0};
-    auto mul = l.size();
-    for (auto c : l) ret += c * mul--;
-    return ret;
-}
+namespace day22 {
+    using Deck = std::pmr::vector<size_t>;
 
-template <typename C>
-static inline size_t container_hash(const C& l) {
-    if (l.empty()) return 0;
-    size_t ret{aoc::hash(l.front())};
-    for (auto it = aoc::advance(l.begin()); it != l.end(); it = aoc::advance(it)) {
-        ret = aoc::combine_hashes(ret, *it);
+    template <typename T, typename Alloc>
+    static inline std::pmr::vector<T> sublist(const std::vector<T, Alloc>& l, size_t n, std::pmr::memory_resource* mr) {
+        return std::pmr::vector<T>(l.begin(), aoc::advance(l.begin(), n), mr);
     }
-    return ret;
-}
 
-template <typename T>
-static inline T pop_front(std::vector<T>& v) {
-    T ret{v.front()};
-    v.erase(v.begin());
-    return ret;
-}
+    template <typename T, typename Alloc>
+    static inline T score(const std::vector<T, Alloc>& l) {
+        T ret{0};
+        auto mul = l.size();
+        for (auto c : l) ret += c * mul--;
+        return ret;
+    }
 
-static inline size_t part1(const std::vector<size_t>& p1_list, const std::vector<size_t>& p2_list) {
-    auto l1 = std::vector<size_t>(p1_list);
-    auto l2 = std::vector<size_t>(p2_list);
-    while (!l1.empty() && !l2.empty()) {
-        auto c1 = pop_front(l1);
-        auto c2 = pop_front(l2);
-        if (c1 > c2) {
-            l1.push_back(c1);
-            l1.push_back(c2);
-        } else {
-            l2.push_back(c2);
-            l2.push_back(c1);
+    template <typename C>
+    static inline size_t container_hash(const C& l) {
+        if (l.empty()) return 0;
+        size_t ret{aoc::hash(l.front())};
+        for (auto it = aoc::advance(l.begin()); it != l.end(); it = aoc::advance(it)) {
+            ret = aoc::combine_hashes(ret, *it);
         }
+        return ret;
+    }
+
+    template <typename T, typename Alloc>
+    static inline T pop_front(std::vector<T, Alloc>& v) {
+        T ret{v.front()};
+        v.erase(v.begin());
+        return ret;
     }
-    return score(l1.empty() ? l2 : l1);
-}
 
-static inline size_t part2_recurse(std::vector<size_t>& l1, std::vector<size_t>& l2, size_t game = 1) {
-    std::set<std::pair<size_t, size_t>> seen_combos{};
-    size_t winner{0};
-    size_t round{1};
-
-    while (!l1.empty() && !l2.empty()) {
-        auto check = std::make_pair(container_hash(l1), container_hash(l2));
-        if (seen_combos.contains(check)) return 1;
-        seen_combos.insert(check);
-        auto p = std::make_pair(pop_front(l1), pop_front(l2));
-        if ((p.first <= l1.size()) && (p.second <= l2.size())) {
-            auto t1 = sublist(l1, p.first);
-            auto t2 = sublist(l2, p.second);
-            winner = part2_recurse(t1, t2, game + 1);
-        } else {
-            winner = p.first > p.second ? 1 : 2;
+    static inline size_t part1(const std::vector<size_t>& p1_list, const std::vector<size_t>& p2_list) {
+        auto l1 = std::vector<size_t>(p1_list);
+        auto l2 = std::vector<size_t>(p2_list);
+        while (!l1.empty() && !l2.empty()) {
+            auto c1 = pop_front(l1);
+            auto c2 = pop_front(l2);
+            if (c1 > c2) {
+                l1.push_back(c1);
+                l1.push_back(c2);
+            } else {
+                l2.push_back(c2);
+                l2.push_back(c1);
+            }
         }
-        if (winner == 1) {
-            l1.push_back(p.first);
-            l1.push_back(p.second);
-        } else {
-            l2.push_back(p.second);
-            l2.push_back(p.first);
+        return score(l1.empty() ? l2 : l1);
+    }
+
+    static inline size_t part2_subgame(const Deck& l1, size_t n1, const Deck& l2, size_t n2, size_t game);
+
+    // `mr` backs the round history; it belongs to the calling game.
+    static inline size_t part2_recurse(Deck& l1, Deck& l2, std::pmr::memory_resource* mr, size_t game = 1) {
+        std::pmr::set<std::pair<size_t, size_t>> seen_combos(mr);
+        size_t winner{0};
+        size_t round{1};
+
+        while (!l1.empty() && !l2.empty()) {
+            auto check = std::make_pair(container_hash(l1), container_hash(l2));
+            if (seen_combos.contains(check)) return 1;
+            seen_combos.insert(check);
+            auto p = std::make_pair(pop_front(l1), pop_front(l2));
+            if ((p.first <= l1.size()) && (p.second <= l2.size())) {
+                winner = part2_subgame(l1, p.first, l2, p.second, game + 1);
+            } else {
+                winner = p.first > p.second ? 1 : 2;
+            }
+            if (winner == 1) {
+                l1.push_back(p.first);
+                l1.push_back(p.second);
+            } else {
+                l2.push_back(p.second);
+                l2.push_back(p.first);
+            }
+            round++;
         }
-        round++;
+
+        return l1.empty() ? 2 : 1;
     }
 
-    return l1.empty() ? 2 : 1;
-}
+    // A sub-game plays with copies of the top of each deck. The copies and the
+    // game's history are only needed until it has a winner, so they all come
+    // from an arena that is dropped in one go when the game ends.
+    static inline size_t part2_subgame(const Deck& l1, size_t n1, const Deck& l2, size_t n2, size_t game) {
+        aoc::Arena arena{};
+        auto t1 = sublist(l1, n1, &arena);
+        auto t2 = sublist(l2, n2, &arena);
+        return part2_recurse(t1, t2, &arena, game);
+    }
 
-static inline size_t part2(const std::vector<size_t>& p1_list, const std::vector<size_t>& p2_list) {
-    auto l1 = std::vector<size_t>(p1_list);
-    auto l2 = std::vector<size_t>(p2_list);
-    part2_recurse(l1, l2);
-    return score(l1.empty() ? l2 : l1);
-}
+    static inline size_t part2(const std::vector<size_t>& p1_list, const std::vector<size_t>& p2_list) {
+        aoc::Arena arena{};
+        auto l1 = sublist(p1_list, p1_list.size(), &arena);
+        auto l2 = sublist(p2_list, p2_list.size(), &arena);
+        part2_recurse(l1, l2, &arena);
+        return score(l1.empty() ? l2 : l1);
+    }
 
-static inline bool read_player_deck(std::vector<size_t>& deck) {
-    std::string line{};
-    if (!std::getline(std::cin, line)) return false;
-    auto sv = aoc::trim(line);
-    if (!sv.starts_with("Player")) return false;
-    while (std::getline(std::cin, line)) {
-        sv = aoc::trim(line);
-        if (sv.empty()) break;
-        deck.push_back(aoc::from_chars<size_t>(sv).value());
+    static inline bool read_player_deck(aoc::Input& input, std::vector<size_t>& deck) {
+        std::string_view record{};
+        if (!input.next_record(record)) return false;
+        auto cards = aoc::Input(record);
+        std::string_view header{};
+        if (!cards.getline(header) || !aoc::trim(header).starts_with("Player")) return false;
+        return aoc::parse_ints(cards.remaining(), '\n', deck).ec == std::errc();
     }
-    return true;
-}
 
-int main() {
-    std::vector<size_t> l1{};
-    std::vector<size_t> l2{};
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params&) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
 
-    if (!read_player_deck(l1)) return 1;
-    if (!read_player_deck(l2)) return 1;
+        std::vector<size_t> l1{};
+        std::vector<size_t> l2{};
 
-    auto p1 = part1(l1, l2);
-    auto p2 = part2(l1, l2);
-    fmt::print("{}\n", p1);
-    fmt::print("{}\n", p2);
+        if (!read_player_deck(input, l1)) return std::nullopt;
+        if (!read_player_deck(input, l2)) return std::nullopt;
 
-    return 0;
+        answer.set_part1(part1(l1, l2));
+        answer.set_part2(part2(l1, l2));
+
+        return answer;
+    }
 }
@@ -1,92 +1,115 @@
 #include <aoc.h>
 
-using Labels = std::list<int>;
-using IteratorCache = std::vector<Labels::iterator>;
-
-static inline Labels::iterator circular_next(Labels& labels, Labels::iterator current) noexcept {
-    auto ret = aoc::advance(current);
-    if (ret == labels.end()) ret = labels.begin();
-    return ret;
-}
-
-static inline Labels::const_iterator circular_next(const Labels& labels, Labels::const_iterator current) noexcept {
-    auto ret = aoc::advance(current);
-    if (ret == labels.end()) ret = labels.begin();
-    return ret;
-}
-
-static inline Labels::iterator move(Labels& labels, Labels::iterator current, IteratorCache& cache) noexcept {
-    auto i1 = circular_next(labels, current);
-    auto i2 = circular_next(labels, i1);
-    auto i3 = circular_next(labels, i2);
-    int next_val = *current - 1;
-    if (next_val < 1) next_val = labels.size();
-    while (next_val == *i1 || next_val == *i2 || next_val == *i3) {
-        next_val -= 1;
-        if (next_val < 1) next_val = labels.size();
-    }
-    auto v1{*i1}, v2{*i2}, v3{*i3};
-    auto ins_it = aoc::advance(cache[next_val]);
-    labels.erase(i1);
-    labels.erase(i2);
-    labels.erase(i3);
-    cache[v1] = labels.insert(ins_it, v1);
-    cache[v2] = labels.insert(ins_it, v2);
-    cache[v3] = labels.insert(ins_it, v3);
-    return circular_next(labels, current);
-}
-
-static inline void part1(Labels labels) noexcept {
-    IteratorCache cache(labels.size() + 1);
-    for (auto it = labels.begin(); it != labels.end(); it++) {
-        cache[*it] = it;
-    }
-
-    auto it = labels.begin();
-    for (size_t i = 0; i < 100; i++)
-        it = move(labels, it, cache);
-
-    std::vector<int> result{};
-    result.reserve(labels.size());
-    auto sentinel = std::find(labels.begin(), labels.end(), 1);
-    for (auto it = circular_next(labels, sentinel); it != sentinel; it = circular_next(labels, it))
-        result.push_back(*it);
-
-    fmt::print("{}\n", fmt::join(result, ""));
-}
-
-static inline void part2(Labels labels) noexcept {
-    IteratorCache cache(labels.size() + 1);
-    for (auto it = labels.begin(); it != labels.end(); it++) {
-        cache[*it] = it;
+namespace day23 {
+    // The circle of cups as a successor array: next_[label] is the label of
+    // the cup clockwise of `label`. A move relinks three entries in place, so
+    // there is no allocation per move and the whole ring costs 4 bytes per
+    // cup. Labels are 1-based; next_[0] is unused.
+    class Ring {
+    public:
+        static inline std::optional<Ring> create(std::span<const uint32_t> labels, uint32_t cups, bool huge_pages = false) {
+            auto next = aoc::PageArray<uint32_t>::allocate(size_t(cups) + 1, huge_pages);
+            if (!next) return std::nullopt;
+
+            Ring ret{};
+            ret.next_ = std::move(next.value());
+            ret.cups_ = cups;
+            ret.current_ = labels.front();
+
+            auto* n = ret.next_.data();
+            for (size_t i = 0; i + 1 < labels.size(); i++) n[labels[i]] = labels[i + 1];
+            auto last = labels.back();
+            for (auto label = uint32_t(labels.size()) + 1; label <= cups; label++) {
+                n[last] = label;
+                last = label;
+            }
+            n[last] = ret.current_;
+            return ret;
+        }
+
+        inline void play(uint64_t moves) noexcept {
+            aoc::ScopeTimer timer{"day23 Ring::play"};
+            aoc::counter("day23 moves") += moves;
+
+            auto* next = next_.data();
+            auto current = current_;
+            const auto wrap = [cups = cups_](uint32_t label) -> uint32_t {
+                return label > 1 ? label - 1 : cups;
+            };
+            for (uint64_t i = 0; i < moves; i++) {
+                auto a = next[current];
+                auto b = next[a];
+                auto c = next[b];
+                auto dest = wrap(current);
+                while (dest == a || dest == b || dest == c) dest = wrap(dest);
+                next[current] = next[c];
+                next[c] = next[dest];
+                next[dest] = a;
+                current = next[current];
+            }
+            current_ = current;
+        }
+
+        inline uint32_t next(uint32_t label) const noexcept {
+            return next_[label];
+        }
+
+    private:
+        aoc::PageArray<uint32_t> next_{};
+        uint32_t cups_{0};
+        uint32_t current_{0};
+    };
+
+    // Options:
+    //   --cups=N        number of cups in part 2 (default: 1000000)
+    //   --moves=N       number of moves in part 2 (default: 10000000)
+    //   --huge-pages    back the part 2 ring with transparent huge pages
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params& params) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
+
+        std::string_view line{};
+        if (!input.getline(line)) return std::nullopt;
+        auto sv = aoc::trim(line);
+        if (sv.empty()) return std::nullopt;
+
+        std::vector<uint32_t> labels{};
+        for (auto c : sv) {
+            auto label = uint32_t(c - '0');
+            if (label < 1 || label > sv.size() || std::find(labels.begin(), labels.end(), label) != labels.end()) {
+                fmt::print(std::cerr, "Invalid cup labels: '{}'\n", sv);
+                return std::nullopt;
+            }
+            labels.push_back(label);
+        }
+        if (labels.size() < 5) {
+            fmt::print(std::cerr, "A move needs at least 5 cups, got {}\n", labels.size());
+            return std::nullopt;
+        }
+
+        auto cups = params.get<uint64_t>("cups", 1000000);
+        auto moves = params.get<uint64_t>("moves", 10000000);
+        auto huge_pages = params.has("huge-pages");
+        if (cups < labels.size() || cups >= std::numeric_limits<uint32_t>::max()) {
+            fmt::print(std::cerr, "--cups must be between {} and {}\n", labels.size(), std::numeric_limits<uint32_t>::max() - 1);
+            return std::nullopt;
+        }
+
+        auto small = Ring::create(labels, uint32_t(labels.size()));
+        if (!small) return std::nullopt;
+        small->play(100);
+        std::string part1{};
+        for (auto label = small->next(1); label != 1; label = small->next(label))
+            part1.push_back(char('0' + label));
+        answer.set_part1(part1);
+
+        auto large = Ring::create(labels, uint32_t(cups), huge_pages);
+        if (!large) return std::nullopt;
+        large->play(moves);
+        auto c1 = large->next(1);
+        auto c2 = large->next(c1);
+        answer.set_part2(uint64_t(c1) * uint64_t(c2));
+
+        return answer;
     }
-
-    cache.resize(1000001);
-    for (int val = labels.size() + 1; labels.size() < 1000000; val++)
-        cache[val] = labels.insert(labels.end(), val);
-
-    auto it = labels.begin();
-    for (size_t i = 0; i < 10000000; i++)
-        it = move(labels, it, cache);
-
-    auto anchor = std::find(labels.begin(), labels.end(), 1);
-    auto i1 = circular_next(labels, anchor);
-    auto i2 = circular_next(labels, i1);
-    auto result{uint64_t(*i1) * uint64_t(*i2)};
-    fmt::print("{}\n", result);
-}
-
-int main() {
-    std::string line{};
-    if (!std::getline(std::cin, line)) return 1;
-    auto sv = aoc::trim(line);
-    if (sv.empty()) return 1;
-
-    Labels labels{};
-    for (auto c : sv) labels.push_back(c - '0');
-
-    part1(labels);
-    part2(labels);
-
-    return 0;
 }
@@ -1,186 +1,390 @@
 #include <aoc.h>
 
-struct Delta {
-    using int_type = int16_t;
-    int_type dx{0};
-    int_type dy{0};
-};
-
-static constexpr const Delta SE{ 1,  1};
-static constexpr const Delta SW{-1,  1};
-static constexpr const Delta  W{-2,  0};
-static constexpr const Delta NW{-1, -1};
-static constexpr const Delta NE{ 1, -1};
-static constexpr const Delta  E{ 2,  0};
-
-struct Position {
-    using bigint_type = int32_t;
-    using int_type = Delta::int_type;
-
-    union {
-        struct {
-            int_type x;
-            int_type y;
-        };
-        bigint_type _v;
+namespace day24 {
+    struct Delta {
+        using int_type = int16_t;
+        int_type dx{0};
+        int_type dy{0};
     };
 
-    Position() noexcept : x(0), y(0) {}
-    Position(int_type ix, int_type iy)  noexcept : x(ix), y(iy) {}
-    Position(bigint_type iv) noexcept : _v(iv) {}
-    Position(const Position& other) noexcept : _v(other._v) {}
-    Position(Position&& other) noexcept : _v(other._v) {}
-    Position& operator=(const Position& other) noexcept {
-        _v = other._v;
-        return *this;
-    }
-    Position& operator=(Position&& other) noexcept {
-        _v = other._v;
-        return *this;
-    }
+    static constexpr const Delta SE{ 1,  1};
+    static constexpr const Delta SW{-1,  1};
+    static constexpr const Delta  W{-2,  0};
+    static constexpr const Delta NW{-1, -1};
+    static constexpr const Delta NE{ 1, -1};
+    static constexpr const Delta  E{ 2,  0};
 
-    inline Position& apply_moves(const std::vector<Delta>& moves) noexcept {
-        *this = aoc::accumulate(moves, *this, [](Position acc, const Delta& d) -> Position {
-            return acc + d;
-        });
-        return *this;
-    }
+    struct Position {
+        using bigint_type = int32_t;
+        using int_type = Delta::int_type;
 
-    inline Position operator+(Delta d) const noexcept {
-        return Position(x + d.dx, y + d.dy);
-    }
+        union {
+            struct {
+                int_type x;
+                int_type y;
+            };
+            bigint_type _v;
+        };
 
-    inline const std::array<Position, 6> neighbours() const noexcept {
-        std::array<Position, 6> ret{};
-        ret[0] = *this + SE;
-        ret[1] = *this + SW;
-        ret[2] = *this + W;
-        ret[3] = *this + NW;
-        ret[4] = *this + NE;
-        ret[5] = *this + E;
-        return ret;
-    }
+        Position() noexcept : x(0), y(0) {}
+        Position(int_type ix, int_type iy)  noexcept : x(ix), y(iy) {}
+        Position(bigint_type iv) noexcept : _v(iv) {}
+        Position(const Position& other) noexcept : _v(other._v) {}
+        Position(Position&& other) noexcept : _v(other._v) {}
+        Position& operator=(const Position& other) noexcept {
+            _v = other._v;
+            return *this;
+        }
+        Position& operator=(Position&& other) noexcept {
+            _v = other._v;
+            return *this;
+        }
 
-    inline bool operator==(Position other) const noexcept {
-        return _v == other._v;
-    }
-};
-static_assert(sizeof(Position) == sizeof(Position::bigint_type));
+        inline Position& apply_moves(const std::vector<Delta>& moves) noexcept {
+            *this = aoc::accumulate(moves, *this, [](Position acc, const Delta& d) -> Position {
+                return acc + d;
+            });
+            return *this;
+        }
+
+        inline Position operator+(Delta d) const noexcept {
+            return Position(x + d.dx, y + d.dy);
+        }
+
+        inline const std::array<Position, 6> neighbours() const noexcept {
+            std::array<Position, 6> ret{};
+            ret[0] = *this + SE;
+            ret[1] = *this + SW;
+            ret[2] = *this + W;
+            ret[3] = *this + NW;
+            ret[4] = *this + NE;
+            ret[5] = *this + E;
+            return ret;
+        }
+
+        inline bool operator==(Position other) const noexcept {
+            return _v == other._v;
+        }
+    };
+    static_assert(sizeof(Position) == sizeof(Position::bigint_type));
+}
 
 namespace std {
-    template<> struct hash<Position> {
-        inline size_t operator()(Position p) const noexcept {
+    template<> struct hash<day24::Position> {
+        inline size_t operator()(day24::Position p) const noexcept {
             return p._v;
         }
     };
 }
 
-static inline bool parse_movements(std::string_view line, std::vector<Delta>& moves) noexcept {
-    auto* it = line.begin();
+namespace day24 {
+    static inline bool parse_movements(std::string_view line, std::vector<Delta>& moves) noexcept {
+        auto* it = line.begin();
 
-    moves.clear();
+        moves.clear();
 
-    while (it < line.end()) {
-        switch (*it) {
-            case 'e': {
-                moves.push_back(E);
-                break;
-            }
-            case 'w': {
-                moves.push_back(W);
-                break;
-            }
-            case 's': {
-                it++;
-                switch (*it) {
-                    case 'e': {
-                        moves.push_back(SE);
-                        break;
+        while (it < line.end()) {
+            switch (*it) {
+                case 'e': {
+                    moves.push_back(E);
+                    break;
+                }
+                case 'w': {
+                    moves.push_back(W);
+                    break;
+                }
+                case 's': {
+                    if (++it == line.end()) goto truncated;
+                    switch (*it) {
+                        case 'e': {
+                            moves.push_back(SE);
+                            break;
+                        }
+                        case 'w': {
+                            moves.push_back(SW);
+                            break;
+                        }
+                        default: goto parse_error;
                     }
-                    case 'w': {
-                        moves.push_back(SW);
-                        break;
+                    break;
+                }
+                case 'n': {
+                    if (++it == line.end()) goto truncated;
+                    switch (*it) {
+                        case 'e': {
+                            moves.push_back(NE);
+                            break;
+                        }
+                        case 'w': {
+                            moves.push_back(NW);
+                            break;
+                        }
+                        default: goto parse_error;
                     }
-                    default: goto parse_error;
+                    break;
                 }
-                break;
+                default: goto parse_error;
             }
-            case 'n': {
-                it++;
-                switch (*it) {
-                    case 'e': {
-                        moves.push_back(NE);
-                        break;
-                    }
-                    case 'w': {
-                        moves.push_back(NW);
-                        break;
+            it++;
+        }
+        return true;
+
+    parse_error:
+        fmt::print(std::cerr, "Failed to parse '{}': '{}' at position {}\n", line, *it, it - line.begin() + 1);
+        return false;
+
+    truncated:
+        fmt::print(std::cerr, "Failed to parse '{}': truncated direction '{}' at position {}\n", line, line.back(), line.size());
+        return false;
+    }
+
+    static inline size_t simulate_set(const aoc::FlatHashSet<Position>& black_tiles, size_t days,
+        Delta::int_type minx, Delta::int_type maxx, Delta::int_type miny, Delta::int_type maxy)
+    {
+        auto current = aoc::FlatHashSet<Position>(black_tiles);
+        auto next = aoc::FlatHashSet<Position>();
+        for (size_t day = 0; day < days; day++) {
+            auto [Mx, mx] = aoc::numeric_limits<Delta::int_type>();
+            auto [My, my] = aoc::numeric_limits<Delta::int_type>();
+
+            for (int y = miny - 1; y < maxy + 2; y++) {
+                for (int x = minx - 1; x < maxx + 2; x++) {
+                    auto p = Position(x, y);
+                    auto n = aoc::accumulate(p.neighbours(), 0, [&current](int acc, const Position& p) -> int {
+                        return acc + current.contains(p);
+                    });
+                    auto is_black = current.contains(p);
+                    auto i = ((is_black && (n == 1 || n == 2)) || (!is_black && (n == 2)));
+                    if (i) {
+                        next.insert(p);
+                        mx = std::min(mx, p.x); Mx = std::max(Mx, p.x);
+                        my = std::min(my, p.y); My = std::max(My, p.y);
                     }
-                    default: goto parse_error;
                 }
-                break;
             }
-            default: goto parse_error;
+
+            std::swap(current, next);
+            next.clear();
+
+            minx = mx; maxx = Mx;
+            miny = my; maxy = My;
         }
-        it++;
+        return current.size();
     }
-    return true;
 
-parse_error:
-    fmt::print(std::cerr, "Failed to parse '{}': '{}' at position {}\n", line, *it, it - line.begin() + 1);
-    return false;
-}
+    // Dense engine. Tiles use axial coordinates: r = y and q = (x - y) / 2.
+    // Every row r is a run of 64-bit words with one bit per q. In those
+    // coordinates the six neighbours of (q, r) are (q +/- 1, r),
+    // (q, r - 1), (q + 1, r - 1), (q - 1, r + 1) and (q, r + 1). So a
+    // word's neighbour counts come from six shifted words, summed
+    // bit-sliced.
+    //
+    // Only the bounding box of the black tiles (plus a one tile border) is
+    // visited. The board doubles in size, keeping the pattern centred,
+    // whenever the box reaches its edge.
+    class HexBoard {
+    public:
+        inline explicit HexBoard(const aoc::FlatHashSet<Position>& black_tiles) {
+            int q_min{0}, q_max{0}, r_min{0}, r_max{0};
+            for (auto p : black_tiles) {
+                auto q = (p.x - p.y) / 2;
+                q_min = std::min(q_min, q); q_max = std::max(q_max, q);
+                r_min = std::min(r_min, int(p.y)); r_max = std::max(r_max, int(p.y));
+            }
+            words_ = size_t(q_max - q_min) / 64 + 3;
+            rows_ = size_t(r_max - r_min) + 3;
+            q_origin_ = 64 - q_min;
+            r_origin_ = 1 - r_min;
+            cells_.resize(words_ * rows_);
+            next_.resize(words_ * rows_);
+            for (auto p : black_tiles) {
+                auto q = size_t((p.x - p.y) / 2 + q_origin_);
+                auto r = size_t(p.y + r_origin_);
+                cells_[r * words_ + q / 64] |= uint64_t(1) << (q % 64);
+            }
+            update_box();
+        }
 
-int main() {
-    std::unordered_set<Position> black_tiles{};
-    std::vector<Delta> moves{};
-    std::string line{};
-    auto [maxx, minx] = aoc::numeric_limits<Delta::int_type>();
-    auto [maxy, miny] = aoc::numeric_limits<Delta::int_type>();
-
-    line.reserve(256);
-    moves.reserve(256);
-
-    while (std::getline(std::cin, line)) {
-        if (!parse_movements(aoc::trim(line), moves)) return 1;
-        auto p = Position().apply_moves(moves);
-        minx = std::min(minx, p.x); maxx = std::max(maxx, p.x);
-        miny = std::min(miny, p.y); maxy = std::max(maxy, p.y);
-        auto it = black_tiles.find(p);
-        if (it != black_tiles.end()) black_tiles.erase(it);
-        else black_tiles.insert(p);
-    }
-    fmt::print("{}\n", black_tiles.size());
-
-    auto current = std::unordered_set<Position>(black_tiles);
-    auto next = std::unordered_set<Position>();
-    for (size_t day = 0; day < 100; day++) {
-        auto [Mx, mx] = aoc::numeric_limits<Delta::int_type>();
-        auto [My, my] = aoc::numeric_limits<Delta::int_type>();
-
-        for (int y = miny - 1; y < maxy + 2; y++) {
-            for (int x = minx - 1; x < maxx + 2; x++) {
-                auto p = Position(x, y);
-                auto n = aoc::accumulate(p.neighbours(), 0, [&current](int acc, const Position& p) -> int {
-                    return acc + current.contains(p);
-                });
-                auto is_black = current.contains(p);
-                auto i = ((is_black && (n == 1 || n == 2)) || (!is_black && (n == 2)));
-                if (i) {
-                    next.insert(p);
-                    mx = std::min(mx, p.x); Mx = std::max(Mx, p.x);
-                    my = std::min(my, p.y); My = std::max(My, p.y);
+        inline void run(size_t days) {
+            aoc::ScopeTimer timer{"day24 HexBoard::run"};
+            aoc::counter("day24 days") += days;
+            for (size_t day = 0; day < days; day++) {
+                if (box_.empty) break;
+                // The step reads one row/word beyond the border it visits.
+                while (box_.r_min < 2 || box_.r_max + 3 > rows_ || box_.k_min < 2 || box_.k_max + 3 > words_) grow();
+                step();
+            }
+        }
+
+        inline size_t population() const {
+            return std::accumulate(cells_.begin(), cells_.end(), size_t(0), [](size_t acc, uint64_t w) -> size_t {
+                return acc + size_t(std::popcount(w));
+            });
+        }
+
+    private:
+        struct Box {
+            size_t r_min{0}, r_max{0};
+            size_t k_min{0}, k_max{0};
+            bool empty{true};
+
+            inline void add(size_t r, size_t k) noexcept {
+                if (empty) {
+                    *this = Box{r, r, k, k, false};
+                    return;
+                }
+                r_min = std::min(r_min, r); r_max = std::max(r_max, r);
+                k_min = std::min(k_min, k); k_max = std::max(k_max, k);
+            }
+        };
+
+        size_t words_{0};
+        size_t rows_{0};
+        int q_origin_{0};
+        int r_origin_{0};
+        std::vector<uint64_t> cells_{};
+        std::vector<uint64_t> next_{};
+        Box box_{};
+
+        inline void update_box() noexcept {
+            box_ = Box{};
+            for (size_t r = 0; r < rows_; r++)
+                for (size_t k = 0; k < words_; k++)
+                    if (cells_[r * words_ + k]) box_.add(r, k);
+        }
+
+        inline void grow() {
+            auto words = words_ * 2;
+            auto rows = rows_ * 2;
+            auto dk = (words - words_) / 2;
+            auto dr = (rows - rows_) / 2;
+            std::vector<uint64_t> cells(words * rows);
+            for (size_t r = box_.r_min; r <= box_.r_max; r++)
+                std::copy_n(cells_.data() + r * words_ + box_.k_min, box_.k_max - box_.k_min + 1,
+                    cells.data() + (r + dr) * words + box_.k_min + dk);
+
+            cells_ = std::move(cells);
+            next_.assign(words * rows, 0);
+            words_ = words;
+            rows_ = rows;
+            q_origin_ += int(dk * 64);
+            r_origin_ += int(dr);
+            box_ = Box{box_.r_min + dr, box_.r_max + dr, box_.k_min + dk, box_.k_max + dk, false};
+        }
+
+        inline void step() noexcept {
+            auto r_lo = box_.r_min - 1, r_hi = box_.r_max + 1;
+            auto k_lo = box_.k_min - 1, k_hi = box_.k_max + 1;
+            const auto* cells = cells_.data();
+            auto* next = next_.data();
+
+            Box box{};
+            for (auto r = r_lo; r <= r_hi; r++) {
+                const auto* above = cells + (r - 1) * words_;
+                const auto* row = cells + r * words_;
+                const auto* below = cells + (r + 1) * words_;
+                for (auto k = k_lo; k <= k_hi; k++) {
+                    // Bit q of east(w) is bit q + 1 of the row, west(w) bit q - 1.
+                    const auto east = [k](const uint64_t* w) { return (w[k] >> 1) | (w[k + 1] << 63); };
+                    const auto west = [k](const uint64_t* w) { return (w[k] << 1) | (w[k - 1] >> 63); };
+
+                    auto v0 = east(row), v1 = west(row);
+                    auto v2 = above[k], v3 = east(above);
+                    auto v4 = west(below), v5 = below[k];
+
+                    auto s0 = v0 ^ v1 ^ v2, c0 = (v0 & v1) | (v0 & v2) | (v1 & v2);
+                    auto s1 = v3 ^ v4 ^ v5, c1 = (v3 & v4) | (v3 & v5) | (v4 & v5);
+                    auto ones = s0 ^ s1, twos = (c0 ^ c1) ^ (s0 & s1);
+                    auto fours = (c0 & c1) | ((c0 ^ c1) & (s0 & s1));
+
+                    auto two = ~ones & twos & ~fours;
+                    auto one = ones & ~twos & ~fours;
+                    auto w = two | (row[k] & one);
+                    next[r * words_ + k] = w;
+                    if (w) box.add(r, k);
                 }
             }
+
+            // The old generation only has bits inside the old box, which the
+            // loop above has just overwritten; the rest of next_ is already
+            // clear.
+            std::swap(cells_, next_);
+            for (auto r = box_.r_min; r <= box_.r_max; r++)
+                std::fill_n(next_.data() + r * words_ + box_.k_min, box_.k_max - box_.k_min + 1, 0);
+            box_ = box;
         }
+    };
 
-        std::swap(current, next);
-        next.clear();
+    // The same axial layout on the generic automaton. Nothing ever grows by
+    // more than one tile per day, so a margin of `days` on each side holds
+    // the whole run.
+    static inline size_t simulate_ca(const aoc::FlatHashSet<Position>& black_tiles, size_t days, aoc::ThreadPool* pool) {
+        using Floor = aoc::CellularAutomaton<2, aoc::ca::hex_axial(), aoc::ca::rule({2}, {1, 2})>;
 
-        minx = mx; maxx = Mx;
-        miny = my; maxy = My;
+        int q_min{0}, q_max{0}, r_min{0}, r_max{0};
+        for (auto p : black_tiles) {
+            auto q = (p.x - p.y) / 2;
+            q_min = std::min(q_min, q); q_max = std::max(q_max, q);
+            r_min = std::min(r_min, int(p.y)); r_max = std::max(r_max, int(p.y));
+        }
+        auto margin = ptrdiff_t(days) + 1;
+        Floor floor({size_t(q_max - q_min + 2 * margin), size_t(r_max - r_min + 2 * margin)}, pool);
+        for (auto p : black_tiles) {
+            auto q = size_t((p.x - p.y) / 2 - q_min + margin);
+            auto r = size_t(p.y - r_min + margin);
+            floor.set({q, r});
+        }
+        floor.run(days);
+        return floor.population();
     }
-    fmt::print("{}\n", current.size());
 
-    return 0;
+    // Options:
+    //   --engine=bits|ca|set  part 2 engine (default: bits)
+    //   --days=N              number of days to simulate in part 2 (default: 100)
+    //   --threads=N           worker threads of the ca engine (default: 1)
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params& params) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
+
+        auto engine = params.get<std::string_view>("engine", "bits");
+        auto days = params.get<size_t>("days", 100);
+        if (engine != "bits" && engine != "ca" && engine != "set") {
+            fmt::print(std::cerr, "Unknown engine '{}' (expected 'bits', 'ca' or 'set')\n", engine);
+            return std::nullopt;
+        }
+
+        aoc::FlatHashSet<Position> black_tiles{};
+        std::vector<Delta> moves{};
+        std::string_view line{};
+        auto [maxx, minx] = aoc::numeric_limits<Delta::int_type>();
+        auto [maxy, miny] = aoc::numeric_limits<Delta::int_type>();
+
+        moves.reserve(256);
+
+        while (input.getline(line)) {
+            if (!parse_movements(aoc::trim(line), moves)) return std::nullopt;
+            auto p = Position().apply_moves(moves);
+            minx = std::min(minx, p.x); maxx = std::max(maxx, p.x);
+            miny = std::min(miny, p.y); maxy = std::max(maxy, p.y);
+            auto it = black_tiles.find(p);
+            if (it != black_tiles.end()) black_tiles.erase(it);
+            else black_tiles.insert(p);
+        }
+        answer.set_part1(black_tiles.size());
+
+        if (engine == "set") {
+            answer.set_part2(simulate_set(black_tiles, days, minx, maxx, miny, maxy));
+        } else if (engine == "ca") {
+            auto threads = params.get<size_t>("threads", 1);
+            std::optional<aoc::ThreadPool> pool{};
+            if (threads > 1) pool.emplace(threads);
+            answer.set_part2(simulate_ca(black_tiles, days, pool ? &pool.value() : nullptr));
+        } else {
+            HexBoard board(black_tiles);
+            board.run(days);
+            answer.set_part2(board.population());
+        }
+
+        return answer;
+    }
 }
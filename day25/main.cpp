@@ -1,37 +1,60 @@
 #include <aoc.h>
 
-static inline uint64_t determine_loop_size(uint64_t public_key, uint64_t subject_number) noexcept {
-    uint64_t value{1};
-    uint64_t loop_size{1};
-    for (loop_size = 0; value != public_key; loop_size++) {
-        value = (value * subject_number) % 20201227llu;
-    }
-    return loop_size;
-}
+namespace day25 {
+    // The handshake is exponentiation in the multiplicative group modulo a
+    // prime: public_key = subject^loop_size. The loop size is a discrete log
+    // (baby-step giant-step) and the encryption key a modular power, both in
+    // Montgomery form.
+    //
+    // Options:
+    //   --modulus=N   modulus of the handshake (default: 20201227)
+    //   --subject=N   subject number of the public keys (default: 7)
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params& params) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
 
-static inline uint64_t transform(uint64_t subject_number, uint64_t loop_size) noexcept {
-    uint64_t value{1};
-    for (uint64_t iter = 0; iter < loop_size; iter++) {
-        value = (value * subject_number) % 20201227llu;
-    }
-    return value;
-}
+        auto modulus = params.get<uint64_t>("modulus", 20201227);
+        auto subject = params.get<uint64_t>("subject", 7);
+        if (modulus < 2) {
+            fmt::print(std::cerr, "--modulus must be at least 2\n");
+            return std::nullopt;
+        }
+        if (subject == 0 || subject >= modulus) {
+            fmt::print(std::cerr, "--subject must be between 1 and {}\n", modulus - 1);
+            return std::nullopt;
+        }
+        if (aoc::gcd(subject, modulus) != 1) {
+            fmt::print(std::cerr, "--subject {} is not invertible modulo {}\n", subject, modulus);
+            return std::nullopt;
+        }
+        if (modulus > aoc::discrete_log_max_baby_steps * aoc::discrete_log_max_baby_steps) {
+            fmt::print(std::cerr, "--modulus must be at most {}\n",
+                aoc::discrete_log_max_baby_steps * aoc::discrete_log_max_baby_steps);
+            return std::nullopt;
+        }
 
-int main() {
-    uint64_t pub_key_card{0};
-    uint64_t pub_key_door{0};
+        uint64_t pub_key_card{0};
+        uint64_t pub_key_door{0};
 
-    std::string line{};
-    if (!std::getline(std::cin, line)) return 1;
-    if (!aoc::from_chars(aoc::trim(line), pub_key_card)) return 1;
-    if (!std::getline(std::cin, line)) return 1;
-    if (!aoc::from_chars(aoc::trim(line), pub_key_door)) return 1;
+        std::string_view line{};
+        if (!input.getline(line)) return std::nullopt;
+        if (!aoc::from_chars(aoc::trim(line), pub_key_card)) return std::nullopt;
+        if (!input.getline(line)) return std::nullopt;
+        if (!aoc::from_chars(aoc::trim(line), pub_key_door)) return std::nullopt;
+        if (pub_key_card >= modulus || pub_key_door >= modulus) {
+            fmt::print(std::cerr, "Public keys must be smaller than the modulus ({})\n", modulus);
+            return std::nullopt;
+        }
 
-    auto loop_size_card = determine_loop_size(pub_key_card, 7);
-    auto loop_size_door = determine_loop_size(pub_key_door, 7);
+        auto loop_size_card = aoc::discrete_log(subject, pub_key_card, modulus);
+        if (!loop_size_card) {
+            fmt::print(std::cerr, "No loop size turns {} into {} modulo {}\n", subject, pub_key_card, modulus);
+            return std::nullopt;
+        }
 
-    auto encryption_key = transform(pub_key_door, loop_size_card);
-    fmt::print("{}\n", encryption_key);
+        auto encryption_key = aoc::powmod(pub_key_door, *loop_size_card, modulus);
+        answer.set_part1(encryption_key);
 
-    return 0;
+        return answer;
+    }
 }
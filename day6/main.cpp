@@ -1,40 +1,39 @@
 #include <aoc.h>
 
-int main() {
-    std::string line{};
-    std::array<size_t, 26> answers{};
-    size_t p1{0};
-    size_t p2{0};
-    size_t people_in_group{0};
+namespace day6 {
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params&) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
 
-    answers.fill(0);
+        std::array<size_t, 26> answers{};
+        size_t p1{0};
+        size_t p2{0};
 
-    const auto update_sums = [&]() {
-        p1 += std::accumulate(answers.begin(), answers.end(), size_t(0), [](size_t sum, size_t v) {
-            return sum + (v != 0);
-        });
-        p2 += std::accumulate(answers.begin(), answers.end(), size_t(0), [people_in_group](size_t sum, size_t v) {
-            return sum + (v == people_in_group);
-        });
-    };
-
-    while (std::getline(std::cin, line)) {
-        if (line.empty()) {
-            update_sums();
+        std::string_view record{};
+        while (input.next_record(record)) {
+            size_t people_in_group{0};
             answers.fill(0);
-            people_in_group = 0;
-            continue;
-        }
-        for (auto ch : line) {
-            answers[ch - 'a'] += 1;
+
+            auto group = aoc::Input(record);
+            std::string_view line{};
+            while (group.getline(line)) {
+                for (auto ch : aoc::trim(line)) {
+                    answers[ch - 'a'] += 1;
+                }
+                people_in_group += 1;
+            }
+
+            p1 += std::accumulate(answers.begin(), answers.end(), size_t(0), [](size_t sum, size_t v) {
+                return sum + (v != 0);
+            });
+            p2 += std::accumulate(answers.begin(), answers.end(), size_t(0), [people_in_group](size_t sum, size_t v) {
+                return sum + (v == people_in_group);
+            });
         }
-        people_in_group += 1;
-    }
-    if (!line.empty())
-        update_sums();
 
-    fmt::print("{}\n", p1);
-    fmt::print("{}\n", p2);
+        answer.set_part1(p1);
+        answer.set_part2(p2);
 
-    return 0;
+        return answer;
+    }
 }
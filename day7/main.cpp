@@ -1,93 +1,331 @@
 #include <aoc.h>
 
-struct Node {
-    std::string name{};
-    size_t count{0};
-};
-std::ostream& operator<<(std::ostream& out, const Node& node) {
-    out << "{\"" << node.name << "\", " << node.count << '}';
-    return out;
-}
+namespace day7 {
+    using Count = unsigned __int128;
 
-static std::map<std::string, std::vector<Node>> bags{};
+    // The rules as a graph over interned colours: every distinct name gets a
+    // dense id in order of first appearance, and edges (bag -> the bags it
+    // holds directly, with their counts) live in compressed sparse rows, both
+    // forwards and backwards. Names are views into the puzzle input, which
+    // outlives the graph.
+    class BagGraph {
+    public:
+        static inline std::optional<BagGraph> parse(aoc::Input& input) {
+            struct Edge {
+                uint32_t parent;
+                uint32_t child;
+                uint32_t count;
+            };
 
-static std::vector<Node>& get_bag(const std::string& name) {
-    auto r = bags.find(name);
-    if (r != bags.end()) return r->second;
-    auto [it, in] = bags.emplace(std::make_pair(name, std::vector<Node>{}));
-    return it->second;
-}
+            BagGraph ret{};
+            std::vector<Edge> edges{};
+            std::string_view line{};
+            while (input.getline(line)) {
+                auto rule = aoc::match<"\\s*(.+?)\\s+bags?\\s+contain\\s+(.+?)\\.?\\s*">(line);
+                if (!rule) continue;
 
-static size_t can_contain(const std::vector<Node>& nodes, const std::string& name) {
-    for (const auto& node : nodes) {
-        if (node.name == name) return node.count;
-    }
-    return 0;
-}
+                auto [name, contents] = rule.value();
+                auto parent = ret.intern(name);
+                for (auto p : aoc::split_view(contents, ',')) {
+                    auto child = aoc::match<"\\s*(\\d+)\\s+(.+?)\\s+bags?\\s*">(p);
+                    if (!child) continue;
 
-static size_t count_sub_bags(const std::string& name) {
-    const auto& contains = bags.at(name);
-    size_t ret{0};
+                    uint32_t count{0};
+                    if (!aoc::from_chars(child->at(0), count)) {
+                        fmt::print(std::cerr, "Invalid bag count on line {}: '{}'\n", input.line_of(line.data()), child->at(0));
+                        return std::nullopt;
+                    }
+                    edges.push_back({parent, ret.intern(child->at(1)), count});
+                }
+            }
 
-    for (const auto& it : contains) {
-        ret += it.count + it.count * count_sub_bags(it.name);
-    }
+            auto n = ret.names_.size();
+            ret.child_first_.assign(n + 1, 0);
+            ret.parent_first_.assign(n + 1, 0);
+            for (const auto& e : edges) {
+                ret.child_first_[e.parent + 1]++;
+                ret.parent_first_[e.child + 1]++;
+            }
+            std::partial_sum(ret.child_first_.begin(), ret.child_first_.end(), ret.child_first_.begin());
+            std::partial_sum(ret.parent_first_.begin(), ret.parent_first_.end(), ret.parent_first_.begin());
 
-    return ret;
-}
+            ret.children_.resize(edges.size());
+            ret.counts_.resize(edges.size());
+            ret.parents_.resize(edges.size());
+            auto child_fill = ret.child_first_;
+            auto parent_fill = ret.parent_first_;
+            for (const auto& e : edges) {
+                auto c = child_fill[e.parent]++;
+                ret.children_[c] = e.child;
+                ret.counts_[c] = e.count;
+                ret.parents_[parent_fill[e.child]++] = e.parent;
+            }
 
-static void part1(const std::string& target) {
-    std::vector<std::string> search_terms{};
-    std::set<std::string> ret{};
+            // Kahn's algorithm over the reverse edges: a colour is ready once
+            // everything it holds is, so `order_` lists contents before their
+            // containers. Colours on a cycle never become ready.
+            std::vector<uint32_t> pending(n);
+            for (size_t b = 0; b < n; b++) {
+                pending[b] = ret.child_first_[b + 1] - ret.child_first_[b];
+                if (!pending[b]) ret.order_.push_back(uint32_t(b));
+            }
+            for (size_t head = 0; head < ret.order_.size(); head++) {
+                auto b = ret.order_[head];
+                for (auto i = ret.parent_first_[b]; i < ret.parent_first_[b + 1]; i++)
+                    if (--pending[ret.parents_[i]] == 0) ret.order_.push_back(ret.parents_[i]);
+            }
+            ret.rank_.resize(n);
+            for (size_t r = 0; r < ret.order_.size(); r++) ret.rank_[ret.order_[r]] = uint32_t(r);
+            return ret;
+        }
 
-    search_terms.push_back(target);
+        inline size_t size() const noexcept { return names_.size(); }
+        inline std::string_view name(uint32_t bag) const noexcept { return names_[bag]; }
 
-    while (search_terms.size()) {
-        std::vector<std::string> next_searches{};
-        for (const auto& term : search_terms) {
-            for (const auto& [parent, contains] : bags) {
-                if (can_contain(contains, term)) {
-                    next_searches.push_back(parent);
-                    ret.insert(parent);
+        inline std::optional<uint32_t> find(std::string_view name) const {
+            if (auto it = ids_.find(name); it != ids_.end()) return it->second;
+            return std::nullopt;
+        }
+
+        // Number of colours that eventually hold at least one `bag`: a BFS
+        // over the reverse edges.
+        inline size_t count_containers(uint32_t bag) const {
+            std::vector<uint8_t> seen(size(), 0);
+            std::vector<uint32_t> queue{};
+            queue.push_back(bag);
+            for (size_t head = 0; head < queue.size(); head++) {
+                auto b = queue[head];
+                for (auto i = parent_first_[b]; i < parent_first_[b + 1]; i++) {
+                    auto p = parents_[i];
+                    if (seen[p]) continue;
+                    seen[p] = 1;
+                    queue.push_back(p);
                 }
             }
+            return queue.size() - 1;
         }
-        search_terms = std::move(next_searches);
-    }
 
-    fmt::print("{}\n", ret.size());
-}
+        // count_containers() for a batch of bags, answered from an index of
+        // container counts that is filled in on demand and kept for the
+        // lifetime of the graph: a colour is computed at most once per rule
+        // set, and everything after that is a lookup. Colours not yet indexed
+        // are computed 64 at a time by index_containers(). Rule sets with
+        // cycles fall back to one BFS per colour, remembered the same way.
+        inline std::vector<size_t> count_containers(std::span<const uint32_t> bags) {
+            aoc::ScopeTimer timer{"day7 BagGraph::count_containers (batch)"};
 
-static void part2(const std::string& target) {
-    fmt::print("{}\n", count_sub_bags(target));
-}
+            if (containers_.empty()) containers_.assign(size(), unknown);
+            std::vector<uint32_t> pending{};
+            for (auto b : bags) {
+                if (containers_[b] != unknown) continue;
+                containers_[b] = queued;
+                pending.push_back(b);
+            }
+
+            if (order_.size() != size()) {
+                for (auto b : pending) containers_[b] = uint32_t(count_containers(b));
+            } else {
+                std::vector<uint64_t> reach(size(), 0);
+                std::vector<uint64_t> active((size() + 63) / 64, 0);
+                for (size_t base = 0; base < pending.size(); base += 64) {
+                    auto chunk = std::min<size_t>(64, pending.size() - base);
+                    index_containers(std::span(pending).subspan(base, chunk), reach, active);
+                }
+            }
+
+            std::vector<size_t> ret{};
+            ret.reserve(bags.size());
+            for (auto b : bags) ret.push_back(containers_[b]);
+            return ret;
+        }
+
+        // Total number of bags inside one `bag`. Every colour's total is
+        // computed once (depth first, without recursion, since chains can be
+        // as long as the rule set) and remembered across calls, so shared
+        // sub-bags cost nothing after the first time. Fails on rules that
+        // put a bag inside itself and on totals beyond 128 bits.
+        inline std::optional<Count> count_contents(uint32_t bag) {
+            if (totals_.empty()) {
+                totals_.assign(size(), 0);
+                state_.assign(size(), State::unvisited);
+            }
+
+            std::vector<std::pair<uint32_t, uint32_t>> stack{};
+            const auto visit = [&](uint32_t b) -> bool {
+                switch (state_[b]) {
+                    case State::done: return true;
+                    case State::in_progress: {
+                        fmt::print(std::cerr, "Bag '{}' ends up inside itself\n", name(b));
+                        return false;
+                    }
+                    case State::failed: return false;
+                    case State::unvisited: break;
+                }
+                state_[b] = State::in_progress;
+                stack.emplace_back(b, child_first_[b]);
+                return true;
+            };
+
+            if (!visit(bag)) return std::nullopt;
+            while (!stack.empty()) {
+                auto& [b, edge] = stack.back();
+                if (edge < child_first_[b + 1]) {
+                    auto child = children_[edge++];
+                    if (!visit(child)) {
+                        for (auto [s, _] : stack) state_[s] = State::failed;
+                        return std::nullopt;
+                    }
+                    continue;
+                }
+
+                Count total{0};
+                for (auto i = child_first_[b]; i < child_first_[b + 1]; i++) {
+                    Count sub{0};
+                    if (__builtin_add_overflow(totals_[children_[i]], Count(1), &sub) ||
+                        __builtin_mul_overflow(sub, Count(counts_[i]), &sub) ||
+                        __builtin_add_overflow(total, sub, &total))
+                    {
+                        fmt::print(std::cerr, "Bag '{}' holds more than 2^128 bags\n", name(b));
+                        for (auto [s, _] : stack) state_[s] = State::failed;
+                        return std::nullopt;
+                    }
+                }
+                totals_[b] = total;
+                state_[b] = State::done;
+                stack.pop_back();
+            }
+            return totals_[bag];
+        }
 
-int main() {
-    const auto split_re = std::regex("\\s+bags?(?:\\s+contain\\s+)?(?:[,. ]+)?");
-    std::string line{};
+        // count_contents() for a batch of bags; the memoised totals make the
+        // whole batch O(V + E).
+        inline std::optional<std::vector<Count>> count_contents(std::span<const uint32_t> bags) {
+            aoc::ScopeTimer timer{"day7 BagGraph::count_contents (batch)"};
 
-    while (std::getline(std::cin, line)) {
-        auto parts = aoc::str_split(line, split_re);
-        if (parts.size() < 2) continue;
+            std::vector<Count> ret{};
+            ret.reserve(bags.size());
+            for (auto bag : bags) {
+                auto total = count_contents(bag);
+                if (!total) return std::nullopt;
+                ret.push_back(*total);
+            }
+            return ret;
+        }
 
-        auto& children = get_bag(std::string(parts[0]));
-        for (size_t i = 1; i < parts.size(); i++) {
-            auto p = parts.at(i);
-            if (p == "no other") continue;
+    private:
+        static constexpr const uint32_t unknown = std::numeric_limits<uint32_t>::max();
+        static constexpr const uint32_t queued = unknown - 1;
 
-            size_t count{0};
-            auto c = std::from_chars(p.begin(), p.end(), count);
-            p = std::string_view(c.ptr + 1, p.end());
+        enum class State : uint8_t {
+            unvisited,
+            in_progress,
+            done,
+            failed,
+        };
 
-            children.push_back(Node {
-                .name = std::string(p),
-                .count = count,
-            });
+        std::vector<std::string_view> names_{};
+        aoc::FlatHashMap<std::string_view, uint32_t> ids_{};
+        std::vector<uint32_t> child_first_{};
+        std::vector<uint32_t> children_{};
+        std::vector<uint32_t> counts_{};
+        std::vector<uint32_t> parent_first_{};
+        std::vector<uint32_t> parents_{};
+        std::vector<uint32_t> order_{};
+        std::vector<uint32_t> rank_{};
+        std::vector<uint32_t> containers_{};
+        std::vector<Count> totals_{};
+        std::vector<State> state_{};
+
+        inline uint32_t intern(std::string_view name) {
+            auto [it, inserted] = ids_.try_emplace(name, uint32_t(names_.size()));
+            if (inserted) names_.push_back(name);
+            return it->second;
         }
-    }
 
-    part1("shiny gold");
-    part2("shiny gold");
+        // Container counts of up to 64 colours in one pass over an acyclic
+        // rule set. Bit j of reach[b] says that b is (or holds) chunk[j]. The
+        // walk goes through `order_`, contents first, so a colour's bits are
+        // final when it is reached, and pushes them on to the colours holding
+        // it. Bit r of `active` marks order_[r] as having bits, and the walk
+        // only visits marked colours: a pass costs the union of its queries'
+        // BFS plus a V / 64 word scan, not O(V + E). The colours with bit j
+        // set are summed in bit-sliced counters, where bit j of slices[i] is
+        // bit i of the j-th count. Adding a row is then a short ripple-carry
+        // add over whole words instead of one increment per set bit. `reach`
+        // and `active` must be all zeros, and are left that way.
+        inline void index_containers(std::span<const uint32_t> chunk, std::vector<uint64_t>& reach,
+            std::vector<uint64_t>& active)
+        {
+            const auto mark = [&](uint32_t b, uint64_t bits) {
+                reach[b] |= bits;
+                active[rank_[b] / 64] |= uint64_t(1) << (rank_[b] % 64);
+            };
 
-    return 0;
+            auto first = order_.size();
+            for (size_t j = 0; j < chunk.size(); j++) {
+                mark(chunk[j], uint64_t(1) << j);
+                first = std::min<size_t>(first, rank_[chunk[j]]);
+            }
+
+            std::array<uint64_t, 32> slices{};
+            // Holders come later in `order_` than what they hold, so marking
+            // never sets a bit behind the one being visited.
+            for (auto w = first / 64; w < active.size(); w++) {
+                while (active[w]) {
+                    auto b = order_[w * 64 + size_t(std::countr_zero(active[w]))];
+                    active[w] &= active[w] - 1;
+                    auto bits = reach[b];
+                    reach[b] = 0;
+                    for (auto i = parent_first_[b]; i < parent_first_[b + 1]; i++) mark(parents_[i], bits);
+                    for (size_t i = 0; bits; i++) {
+                        auto carry = slices[i] & bits;
+                        slices[i] ^= bits;
+                        bits = carry;
+                    }
+                }
+            }
+
+            // Every count includes the colour itself.
+            for (size_t j = 0; j < chunk.size(); j++) {
+                uint32_t count{0};
+                for (size_t i = 0; i < slices.size(); i++) count |= uint32_t((slices[i] >> j) & 1) << i;
+                containers_[chunk[j]] = count - 1;
+            }
+        }
+    };
+
+    // Options:
+    //   --bags=NAME[,NAME...]|all  colours to answer both parts for (default:
+    //                              shiny gold); with several, every answer is
+    //                              a comma separated list in the same order
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params& params) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
+
+        auto graph = BagGraph::parse(input);
+        if (!graph) return std::nullopt;
+
+        auto names = params.get<std::string_view>("bags", "shiny gold");
+        std::vector<uint32_t> bags{};
+        if (names == "all") {
+            bags.resize(graph->size());
+            std::iota(bags.begin(), bags.end(), uint32_t(0));
+        } else {
+            for (auto name : aoc::split_view(names, ',')) {
+                auto bag = graph->find(aoc::trim(name));
+                if (!bag) {
+                    fmt::print(std::cerr, "No rule mentions '{}' bags\n", aoc::trim(name));
+                    return std::nullopt;
+                }
+                bags.push_back(*bag);
+            }
+        }
+
+        answer.set_part1(fmt::format("{}", fmt::join(graph->count_containers(bags), ",")));
+        auto contents = graph->count_contents(bags);
+        if (!contents) return std::nullopt;
+        answer.set_part2(fmt::format("{}", fmt::join(*contents, ",")));
+
+        return answer;
+    }
 }
@@ -1,149 +1,305 @@
 #include <aoc.h>
 
-enum class OpCode {
-    acc,
-    jmp,
-    nop,
-};
-std::ostream& operator<<(std::ostream& out, OpCode code) {
-    switch (code) {
-        case OpCode::acc: {
-            out << "acc";
-            break;
-        }
-        case OpCode::jmp: {
-            out << "jmp";
-            break;
-        }
-        case OpCode::nop: {
-            out << "nop";
-            break;
+namespace day8 {
+    enum class OpCode {
+        acc,
+        jmp,
+        nop,
+    };
+    std::ostream& operator<<(std::ostream& out, OpCode code) {
+        switch (code) {
+            case OpCode::acc: {
+                out << "acc";
+                break;
+            }
+            case OpCode::jmp: {
+                out << "jmp";
+                break;
+            }
+            case OpCode::nop: {
+                out << "nop";
+                break;
+            }
         }
+        return out;
     }
-    return out;
-}
 
-struct Instruction {
-    OpCode code{OpCode::nop};
-    ssize_t arg{0};
-};
-std::ostream& operator<<(std::ostream& out, const Instruction& instr) {
-    out << '{' << instr.code << ' ' << std::showpos << instr.arg << '}';
-    return out;
-}
+    struct Instruction {
+        OpCode code{OpCode::nop};
+        ssize_t arg{0};
+    };
+    std::ostream& operator<<(std::ostream& out, const Instruction& instr) {
+        out << '{' << instr.code << ' ' << std::showpos << instr.arg << '}';
+        return out;
+    }
 
-struct Program {
-    ssize_t acc{0};
-    ssize_t ip{0};
-    std::vector<Instruction> text{};
-
-    static inline std::optional<Program> read() {
-        static const std::regex instruction_re("^([a-z]+)\\s+(\\+|-)(\\d+)");
-        std::string line{};
-        Program ret{};
-        while (std::getline(std::cin, line)) {
-            auto sv = aoc::trim(line);
-            std::cmatch m{};
-            if (!std::regex_match(sv.begin(), sv.end(), m, instruction_re)) {
-                fmt::print(std::cerr, "Invalid instruction on line {}: '{}'\n", ret.text.size() + 1, sv);
-                return {};
-            }
+    struct NoHook {};
 
-            auto ins_sv = aoc::to_sv(m[1]);
-            auto sgn_sv = aoc::to_sv(m[2]);
-            auto arg_sv = aoc::to_sv(m[3]);
+    struct Program {
+        ssize_t acc{0};
+        ssize_t ip{0};
+        std::vector<Instruction> text{};
 
-            Instruction ins{};
-            auto cvr = std::from_chars(arg_sv.begin(), arg_sv.end(), ins.arg);
-            if (cvr.ptr != arg_sv.end()) {
-                fmt::print(std::cerr, "Invalid numeric argument on line {}: '{}{}'\n", ret.text.size() + 1, sgn_sv, arg_sv);
-                return {};
-            }
-            if (sgn_sv.front() == '-') ins.arg *= -1;
-
-            if (ins_sv == "acc") ins.code = OpCode::acc;
-            else if (ins_sv == "jmp") ins.code = OpCode::jmp;
-            else if (ins_sv == "nop") ins.code = OpCode::nop;
-            else {
-                fmt::print(std::cerr, "Invalid instruction mnemonic on line {}: '{}'\n", ret.text.size() + 1, ins_sv);
-                return {};
+        static inline std::optional<Program> read(aoc::Input& input) {
+            std::string_view line{};
+            Program ret{};
+            while (input.getline(line)) {
+                auto sv = aoc::trim(line);
+                auto m = aoc::match<"^([a-z]+)\\s+(\\+|-)(\\d+)">(sv);
+                if (!m) {
+                    fmt::print(std::cerr, "Invalid instruction on line {}: '{}'\n", ret.text.size() + 1, sv);
+                    return {};
+                }
+
+                auto [ins_sv, sgn_sv, arg_sv] = m.value();
+
+                Instruction ins{};
+                auto cvr = std::from_chars(arg_sv.begin(), arg_sv.end(), ins.arg);
+                if (cvr.ptr != arg_sv.end()) {
+                    fmt::print(std::cerr, "Invalid numeric argument on line {}: '{}{}'\n", ret.text.size() + 1, sgn_sv, arg_sv);
+                    return {};
+                }
+                if (sgn_sv.front() == '-') ins.arg *= -1;
+
+                if (ins_sv == "acc") ins.code = OpCode::acc;
+                else if (ins_sv == "jmp") ins.code = OpCode::jmp;
+                else if (ins_sv == "nop") ins.code = OpCode::nop;
+                else {
+                    fmt::print(std::cerr, "Invalid instruction mnemonic on line {}: '{}'\n", ret.text.size() + 1, ins_sv);
+                    return {};
+                }
+
+                ret.text.push_back(ins);
             }
 
-            ret.text.push_back(ins);
+            return ret;
         }
 
-        return ret;
-    }
+        // Runs from the current ip until the program steps outside its text
+        // (returns true) or is about to run an instruction for the second
+        // time (returns false, with ip at that instruction). A Hook, if any,
+        // sees every instruction before it runs as hook(ip, acc) and stops
+        // the run by returning false; without one the loop is hook-free.
+        //
+        // The text is first threaded: every slot holds the address of its
+        // handler and a pre-computed operand (the acc delta or the absolute
+        // jump target), and jumps out of the text land on a trailing halt
+        // slot, so the handlers never bounds check and each one ends in its
+        // own indirect jump to the next. Visited slots are stamped with the
+        // run's generation, which makes starting a new run O(1).
+        template <typename Hook = NoHook>
+        inline bool execute(Hook&& hook = {}) {
+            static constexpr const bool hooked = !std::is_same_v<std::decay_t<Hook>, NoHook>;
+            static const void* const handlers[] = {&&op_acc, &&op_jmp, &&op_nop, &&op_halt};
 
-    inline bool execute(std::function<bool()> pre_instruction_hook = {}) {
-        while (ip >= 0 && ip < ssize_t(text.size())) {
-            if (pre_instruction_hook) {
-                if (!pre_instruction_hook()) return false;
-            }
-            const auto& ins = text.at(ip);
-            switch (ins.code) {
-                case OpCode::acc: {
-                    acc += ins.arg;
-                    break;
-                }
-                case OpCode::jmp: {
-                    ip += ins.arg;
-                    continue;
-                }
-                case OpCode:: nop: {
-                    break;
+            auto n = text.size();
+            if (ip < 0 || ip >= ssize_t(n)) return true;
+
+            threaded_.resize(n + 1);
+            for (size_t i = 0; i < n; i++) {
+                const auto& ins = text[i];
+                switch (ins.code) {
+                    case OpCode::acc: {
+                        threaded_[i] = {handlers[0], ins.arg};
+                        break;
+                    }
+                    case OpCode::jmp: {
+                        auto target = ssize_t(i) + ins.arg;
+                        threaded_[i] = {handlers[1], target >= 0 && target < ssize_t(n) ? target : ssize_t(n)};
+                        break;
+                    }
+                    case OpCode::nop: {
+                        threaded_[i] = {handlers[2], 0};
+                        break;
+                    }
                 }
             }
-            ip += 1;
+            threaded_[n] = {handlers[3], 0};
+
+            if (seen_.size() < n + 1) seen_.resize(n + 1, 0);
+            if (++generation_ == 0) {
+                std::fill(seen_.begin(), seen_.end(), 0);
+                generation_ = 1;
+            }
+
+            const auto* code = threaded_.data();
+            auto* seen = seen_.data();
+            const auto gen = generation_;
+            const Threaded* pc = code + ip;
+            auto a = acc;
+            bool ret{false};
+
+#define DAY8_DISPATCH()                                               \
+            do {                                                      \
+                auto at = size_t(pc - code);                          \
+                if (seen[at] == gen) goto looped;                     \
+                seen[at] = gen;                                       \
+                if constexpr (hooked) {                               \
+                    if (at < n && !hook(ssize_t(at), a)) goto looped; \
+                }                                                     \
+                goto *pc->handler;                                    \
+            } while (0)
+
+            DAY8_DISPATCH();
+        op_acc:
+            a += pc->arg;
+            pc++;
+            DAY8_DISPATCH();
+        op_jmp:
+            pc = code + pc->arg;
+            DAY8_DISPATCH();
+        op_nop:
+            pc++;
+            DAY8_DISPATCH();
+#undef DAY8_DISPATCH
+
+        op_halt:
+            ret = true;
+        looped:
+            ip = pc - code;
+            acc = a;
+            return ret;
         }
-        return true;
-    }
 
-    inline void reset() {
-        ip = 0;
-        acc = 0;
+        inline void reset() {
+            ip = 0;
+            acc = 0;
+        }
+
+    private:
+        struct Threaded {
+            const void* handler{nullptr};
+            ssize_t arg{0};
+        };
+
+        std::vector<Threaded> threaded_{};
+        std::vector<uint32_t> seen_{};
+        uint32_t generation_{0};
+    };
+
+    static inline OpCode flipped(OpCode code) noexcept {
+        switch (code) {
+            case OpCode::jmp: return OpCode::nop;
+            case OpCode::nop: return OpCode::jmp;
+            default: return code;
+        }
     }
-};
-
-int main() {
-    Program prog{};
-    std::set<ssize_t> ip_hist{};
-    if (auto v = Program::read(); !v) {
-        return 1;
-    } else {
-        prog = std::move(v.value());
+
+    // Index of the instruction `code` at `i` continues with; anything
+    // outside [0, n) ends the program.
+    static inline ssize_t successor(const Instruction& ins, OpCode code, size_t i) noexcept {
+        return code == OpCode::jmp ? ssize_t(i) + ins.arg : ssize_t(i) + 1;
     }
 
-    const auto hook = [&]() -> bool {
-        bool ret = !ip_hist.contains(prog.ip);
-        ip_hist.insert(prog.ip);
-        return ret;
-    };
+    // Finds the jmp/nop whose flip makes the program terminate, in O(n).
+    //
+    // Every instruction has exactly one successor, so the program is a
+    // functional graph. Walking its edges backwards from the instructions
+    // that step outside the text marks everything that terminates as it
+    // stands. The original program loops, so no instruction on its path
+    // is marked; flipping one of them helps iff its flipped successor is
+    // marked (or outside the text), and the rest of the new path then
+    // never comes back through the flip. One walk along the path checks
+    // them all. Like the brute force, the lowest such index wins.
+    static inline std::optional<size_t> find_repair(const Program& prog) {
+        aoc::ScopeTimer timer{"day8 find_repair"};
 
-    prog.execute(hook);
-    fmt::print("{}\n", prog.acc);
+        const auto& text = prog.text;
+        auto n = text.size();
+        const auto inside = [n](ssize_t i) { return i >= 0 && i < ssize_t(n); };
 
-    for (auto& ins : prog.text) {
-        auto orig = ins;
-        switch (ins.code) {
-            case OpCode::acc: {
-                continue;
+        // Predecessor lists in CSR form.
+        std::vector<uint32_t> first(n + 1, 0);
+        for (size_t i = 0; i < n; i++)
+            if (auto s = successor(text[i], text[i].code, i); inside(s)) first[size_t(s) + 1]++;
+        std::partial_sum(first.begin(), first.end(), first.begin());
+        std::vector<uint32_t> preds(first[n]);
+        auto fill = first;
+        for (size_t i = 0; i < n; i++)
+            if (auto s = successor(text[i], text[i].code, i); inside(s)) preds[fill[size_t(s)]++] = uint32_t(i);
+
+        std::vector<uint8_t> terminates(n, 0);
+        std::vector<uint32_t> stack{};
+        for (size_t i = 0; i < n; i++) {
+            if (!inside(successor(text[i], text[i].code, i))) {
+                terminates[i] = 1;
+                stack.push_back(uint32_t(i));
             }
-            case OpCode::jmp: {
-                ins.code = OpCode::nop;
-                break;
+        }
+        while (!stack.empty()) {
+            auto i = stack.back();
+            stack.pop_back();
+            for (auto j = first[i]; j < first[i + 1]; j++) {
+                if (terminates[preds[j]]) continue;
+                terminates[preds[j]] = 1;
+                stack.push_back(preds[j]);
             }
-            case OpCode::nop: {
-                ins.code = OpCode::jmp;
-                break;
+        }
+
+        std::optional<size_t> ret{};
+        std::vector<uint8_t> visited(n, 0);
+        for (ssize_t i = 0; inside(i) && !visited[size_t(i)];) {
+            auto at = size_t(i);
+            visited[at] = 1;
+            const auto& ins = text[at];
+            if (ins.code != OpCode::acc && (!ret || at < *ret)) {
+                auto s = successor(ins, flipped(ins.code), at);
+                if (!inside(s) || terminates[size_t(s)]) ret = at;
             }
+            i = successor(ins, ins.code, at);
         }
-        ip_hist.clear();
-        prog.reset();
-        if (prog.execute(hook)) break;
-        ins = orig;
+        return ret;
     }
-    fmt::print("{}\n", prog.acc);
 
-    return 0;
+    // The straightforward repair: flip every jmp/nop in turn and run the
+    // program until one terminates. O(n^2); kept as an oracle for
+    // find_repair().
+    static inline std::optional<size_t> find_repair_brute_force(Program prog) {
+        aoc::ScopeTimer timer{"day8 find_repair_brute_force"};
+
+        for (size_t i = 0; i < prog.text.size(); i++) {
+            auto& ins = prog.text[i];
+            if (ins.code == OpCode::acc) continue;
+            ins.code = flipped(ins.code);
+            prog.reset();
+            if (prog.execute()) return i;
+            ins.code = flipped(ins.code);
+        }
+        return std::nullopt;
+    }
+
+    // Options:
+    //   --repair=cfg|brute-force  how part 2 finds the broken instruction (default: cfg)
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params& params) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
+
+        auto repair = params.get<std::string_view>("repair", "cfg");
+        if (repair != "cfg" && repair != "brute-force") {
+            fmt::print(std::cerr, "Unknown repair method '{}' (expected 'cfg' or 'brute-force')\n", repair);
+            return std::nullopt;
+        }
+
+        Program prog{};
+        if (auto v = Program::read(input); !v) {
+            return std::nullopt;
+        } else {
+            prog = std::move(v.value());
+        }
+
+        prog.execute();
+        answer.set_part1(prog.acc);
+
+        auto broken = repair == "cfg" ? find_repair(prog) : find_repair_brute_force(prog);
+        if (!broken) {
+            fmt::print(std::cerr, "No single jmp/nop flip makes the program terminate\n");
+            return std::nullopt;
+        }
+        prog.text[*broken].code = flipped(prog.text[*broken].code);
+        prog.reset();
+        prog.execute();
+        answer.set_part2(prog.acc);
+
+        return answer;
+    }
 }
@@ -1,68 +1,111 @@
 #include <aoc.h>
 
-static inline size_t part1(const std::vector<size_t>& numbers, size_t window_size = 25) {
-    size_t base_idx{0};
-    size_t test_idx{window_size};
-    std::vector<size_t> sums{};
-
-    sums.reserve(1024);
+namespace day9 {
+    // The last `size` numbers of the stream with a count of every value in
+    // them. A number is valid if some x in the window has its complement
+    // (number - x) in the window too, at a different position: one pass over
+    // the window with a hash lookup each. Sliding the window by one is two
+    // count updates, so a step costs O(w) whatever the window size, and the
+    // memory is O(w) instead of the O(w^2) pairwise sums.
+    class Window {
+    public:
+        inline explicit Window(std::span<const size_t> numbers, size_t size) : numbers_(numbers), size_(size) {
+            counts_.reserve(size);
+            for (size_t i = 0; i < size; i++) counts_[numbers[i]]++;
+        }
 
-    while (test_idx < numbers.size()) {
-        sums.clear();
-        for (auto i = base_idx; i < test_idx; i++) {
-            for (auto j = i + 1; j < test_idx; j++) {
-                sums.push_back(numbers[i] + numbers[j]);
+        inline bool is_pair_sum(size_t target) const noexcept {
+            for (size_t i = begin_; i < begin_ + size_; i++) {
+                auto x = numbers_[i];
+                if (x > target) continue;
+                auto y = target - x;
+                auto it = counts_.find(y);
+                if (it != counts_.end() && (y != x || it->second > 1)) return true;
             }
+            return false;
         }
-        if (std::find(sums.begin(), sums.end(), numbers[test_idx]) == sums.end())
-            return test_idx;
 
-        test_idx += 1;
-        base_idx += 1;
+        inline void slide() {
+            auto out = counts_.find(numbers_[begin_]);
+            if (--out->second == 0) counts_.erase(out);
+            counts_[numbers_[begin_ + size_]]++;
+            begin_++;
+        }
+
+    private:
+        std::span<const size_t> numbers_;
+        size_t size_;
+        size_t begin_{0};
+        aoc::FlatHashMap<size_t, uint32_t> counts_{};
+    };
+
+    static inline std::optional<size_t> part1(std::span<const size_t> numbers, size_t window_size) {
+        aoc::ScopeTimer timer{"day9 part1"};
+        if (numbers.size() <= window_size) return std::nullopt;
+
+        Window window(numbers, window_size);
+        for (auto test_idx = window_size; test_idx < numbers.size(); test_idx++) {
+            if (!window.is_pair_sum(numbers[test_idx])) return test_idx;
+            if (test_idx + 1 < numbers.size()) window.slide();
+        }
+        return std::nullopt;
     }
 
-    return 0;
-}
+    // Numbers are non-negative, so the sum of numbers[lo..hi] only grows
+    // with hi and shrinks with lo: for every hi, dropping numbers from the
+    // front while the sum is too large leaves the longest range ending at hi
+    // whose sum does not exceed the target. O(n) overall.
+    static inline std::optional<size_t> part2(std::span<const size_t> numbers, size_t target_idx) {
+        aoc::ScopeTimer timer{"day9 part2"};
 
-static inline size_t part2(const std::vector<size_t>& numbers, size_t target_idx) {
-    for (size_t window_size = 2; window_size < target_idx; window_size++) {
-        size_t base_idx{0};
-        size_t top_idx{window_size};
-        while (top_idx < target_idx) {
-            auto base_it = numbers.begin() + base_idx;
-            auto top_it = numbers.begin() + top_idx;
-            auto sum = std::accumulate(base_it, top_it, size_t(0));
-            if (sum == numbers[target_idx]) {
-                auto min = std::min_element(base_it, top_it);
-                auto max = std::max_element(base_it, top_it);
+        auto target = numbers[target_idx];
+        size_t lo{0};
+        size_t sum{0};
+        for (size_t hi = 0; hi < target_idx; hi++) {
+            sum += numbers[hi];
+            while (sum > target) sum -= numbers[lo++];
+            if (sum == target && hi > lo) {
+                auto [min, max] = std::minmax_element(numbers.begin() + lo, numbers.begin() + hi + 1);
                 return *min + *max;
             }
-            base_idx += 1;
-            top_idx += 1;
         }
+        return std::nullopt;
     }
-    return 0;
-}
 
-int main() {
-    std::string line{};
-    std::vector<size_t> numbers{};
+    // Options:
+    //   --window=N  length of the preamble and of the sliding window (default: 25)
+    std::optional<aoc::Answer> solve(std::string_view data, const aoc::Params& params) {
+        aoc::Answer answer{};
+        auto input = aoc::Input(data);
 
-    numbers.reserve(1024);
-    while (std::getline(std::cin, line)) {
-        size_t n{0};
-        auto sv = aoc::trim(line);
-        auto rc = std::from_chars(sv.begin(), sv.end(), n);
-        if (rc.ptr != sv.end()) {
-            fmt::print(std::cerr, "Invalid number on line {}: '{}'\n", numbers.size() + 1, line);
-            return 1;
+        auto window_size = params.get<size_t>("window", 25);
+        if (window_size < 2) {
+            fmt::print(std::cerr, "--window must be at least 2\n");
+            return std::nullopt;
+        }
+
+        std::vector<size_t> numbers{};
+
+        numbers.reserve(1024);
+        if (auto rc = aoc::parse_ints(input.data(), '\n', numbers); rc.ec != std::errc()) {
+            fmt::print(std::cerr, "Invalid number on line {}\n", input.line_of(rc.ptr));
+            return std::nullopt;
         }
-        numbers.push_back(n);
-    }
 
-    auto target_idx = part1(numbers);
-    fmt::print("{}\n", numbers[target_idx]);
-    fmt::print("{}\n", part2(numbers, target_idx));
+        auto target_idx = part1(numbers, window_size);
+        if (!target_idx) {
+            fmt::print(std::cerr, "Every number is the sum of two of the {} before it\n", window_size);
+            return std::nullopt;
+        }
+        answer.set_part1(numbers[*target_idx]);
+
+        auto weakness = part2(numbers, *target_idx);
+        if (!weakness) {
+            fmt::print(std::cerr, "No contiguous range adds up to {}\n", numbers[*target_idx]);
+            return std::nullopt;
+        }
+        answer.set_part2(*weakness);
 
-    return 0;
+        return answer;
+    }
 }
@@ -0,0 +1,32 @@
+#include <aoc.h>
+
+#include "check.h"
+
+namespace {
+    using aoc::test::check;
+
+    void test_from_chars() {
+        int value{0};
+        check(aoc::from_chars("1234", value) && value == 1234, "from_chars parses 1234");
+        check(aoc::from_chars("-17", value) && value == -17, "from_chars parses -17");
+        check(aoc::from_chars("ff", value, 16) && value == 255, "from_chars parses ff in base 16");
+        check(!aoc::from_chars("", value), "from_chars rejects an empty string");
+        check(!aoc::from_chars("99999999999", value), "from_chars rejects a value that overflows int");
+        check(!aoc::from_chars("12x", value), "from_chars rejects trailing characters");
+        uint8_t byte{0};
+        check(!aoc::from_chars("256", byte), "from_chars rejects a value that overflows uint8_t");
+
+        check(aoc::from_chars<int>("1234") == 1234, "from_chars<int> parses 1234");
+        check(aoc::from_chars<int>("-17") == -17, "from_chars<int> parses -17");
+        check(aoc::from_chars<int>("ff", 16) == 255, "from_chars<int> parses ff in base 16");
+        check(!aoc::from_chars<int>(""), "from_chars<int> rejects an empty string");
+        check(!aoc::from_chars<int>("99999999999"), "from_chars<int> rejects a value that overflows int");
+        check(!aoc::from_chars<int>("12x"), "from_chars<int> rejects trailing characters");
+        check(!aoc::from_chars<uint8_t>("256"), "from_chars<uint8_t> rejects a value that overflows uint8_t");
+    }
+}
+
+int main() {
+    test_from_chars();
+    return aoc::test::result();
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <iostream>
+#include <source_location>
+#include <string_view>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+namespace aoc::test {
+    inline int failures{0};
+
+    // Records (and reports) a failed expectation instead of aborting, so one
+    // run lists every broken case.
+    inline bool check(bool ok, std::string_view what, std::source_location loc = std::source_location::current()) {
+        if (!ok) {
+            fmt::print(std::cerr, "{}:{}: check failed: {}\n", loc.file_name(), loc.line(), what);
+            failures++;
+        }
+        return ok;
+    }
+
+    inline int result() {
+        if (failures) fmt::print(std::cerr, "{} check(s) failed\n", failures);
+        return failures ? 1 : 0;
+    }
+}
@@ -0,0 +1,39 @@
+#include <aoc.h>
+
+#include "check.h"
+
+namespace {
+    using aoc::test::check;
+
+    template <typename Map>
+    bool throws_out_of_range(Map& map, const typename Map::key_type& key) {
+        try {
+            map.at(key);
+        } catch (const std::out_of_range&) {
+            return true;
+        }
+        return false;
+    }
+
+    void test_map_at() {
+        aoc::FlatHashMap<uint64_t, int> map{};
+        map[3] = 30;
+        map[7] = 70;
+        const auto& cmap = map;
+
+        check(map.at(3) == 30 && cmap.at(7) == 70, "at() finds present keys");
+        map.at(3) = 31;
+        check(map.at(3) == 31, "at() returns a reference into the map");
+        check(throws_out_of_range(map, 5), "at() throws std::out_of_range for a missing key");
+        check(throws_out_of_range(cmap, 5), "const at() throws std::out_of_range for a missing key");
+        check(map.size() == 2, "at() does not insert missing keys");
+
+        aoc::FlatHashMap<uint64_t, int> empty{};
+        check(throws_out_of_range(empty, 0), "at() throws on an empty map");
+    }
+}
+
+int main() {
+    test_map_at();
+    return aoc::test::result();
+}
@@ -0,0 +1,52 @@
+#include <aoc.h>
+
+#include "check.h"
+
+namespace {
+    using aoc::test::check;
+
+    void test_discrete_log() {
+        check(aoc::discrete_log(7, 5764801, 20201227) == 8, "discrete_log finds the card loop size");
+        check(aoc::discrete_log(3, 13, 17) == 4, "discrete_log finds 3^4 == 13 (mod 17)");
+        check(aoc::discrete_log(2, 3, 8) == std::nullopt, "discrete_log rejects a base that is not invertible");
+        check(aoc::discrete_log(3, 2, 18446744073709551557ull) == std::nullopt,
+            "discrete_log rejects bounds that need too many baby steps");
+        check(aoc::discrete_log(3, 2, 18446744073709551557ull, (uint64_t(1) << 50) + 1) == std::nullopt,
+            "discrete_log rejects a bound just above 2^50");
+    }
+
+    void check_crt(std::initializer_list<aoc::Congruence> system, std::string_view value, std::string_view modulus) {
+        auto ret = aoc::crt(std::span<const aoc::Congruence>(system.begin(), system.size()));
+        if (!check(ret.has_value(), fmt::format("crt has a solution for {} congruences", system.size()))) return;
+        check(ret->value.to_string() == value, fmt::format("crt value {} == {}", ret->value, value));
+        check(ret->modulus.to_string() == modulus, fmt::format("crt modulus {} == {}", ret->modulus, modulus));
+    }
+
+    void test_crt() {
+        check_crt({{3, 5}, {2, 7}}, "23", "35");
+        check_crt({{2, 4}, {4, 6}}, "10", "12");
+        check(!aoc::crt(std::vector<aoc::Congruence>{{1, 4}, {2, 6}}), "crt rejects contradicting congruences");
+
+        // Moduli above 2^63, where a - r + m no longer fits in 64 bits.
+        check_crt({{12345, 18446744073709551557ull}}, "12345", "18446744073709551557");
+        check_crt({{4054449127431ull, 18446744073709551557ull}, {5703716569095ull, 18446744073709551533ull}},
+            "1267650600228229401496703205383", "340282366920938460843936948965011886881");
+        check_crt({{5076944378725480864ull, 18446744073709551614ull}, {5076944053464829120ull, 9223372036854775810ull}},
+            "1000000000000000000000000000000", "85070591730234615875067023894796828670");
+        check(!aoc::crt(std::vector<aoc::Congruence>{{1, 18446744073709551614ull}, {2, 9223372036854775810ull}}),
+            "crt rejects contradicting congruences near 2^64");
+
+        // Three moduli near 2^64 outgrow 128 bits, so the last merge runs on
+        // BigUint.
+        check_crt({{14600384569ull, 18446744073709551557ull}, {28894572601ull, 18446744073709551533ull},
+                      {37853605945ull, 18446744073709551521ull}},
+            "1427247692705959881058285969449495136382758969",
+            "6277101735386680683188868462945250914462856766432493496001");
+    }
+}
+
+int main() {
+    test_discrete_log();
+    test_crt();
+    return aoc::test::result();
+}
@@ -0,0 +1,78 @@
+#include <aoc.h>
+#include <days.h>
+
+#if !defined(AOC_SOURCE_DIR)
+#define AOC_SOURCE_DIR "."
+#endif
+
+// Solves any subset of days concurrently in a single process, each on its
+// `dayN/input` file, and prints the answers in day order. Usage:
+//
+//   aoc_all [--jobs=N] [--inputs=DIR] [day...]
+//
+// Options other than the ones above are forwarded to the solvers.
+
+struct DayRun {
+    std::optional<aoc::Answer> answer{};
+    std::chrono::nanoseconds time{};
+};
+
+int main(int argc, char* argv[]) {
+    auto params = aoc::Params(argc, argv);
+    auto jobs = params.get<size_t>("jobs", aoc::ThreadPool::default_size());
+    auto inputs_dir = params.get<std::string_view>("inputs", AOC_SOURCE_DIR);
+
+    auto days = aoc::select_days(params);
+    if (!days) return 1;
+
+    // Inputs are loaded up front so that the workers only ever time solve().
+    std::vector<aoc::Input> inputs{};
+    inputs.reserve(days->size());
+    for (const auto& day : days.value()) {
+        auto path = fmt::format("{}/day{}/input", inputs_dir, day.number);
+        auto input = aoc::Input::from_file(path.c_str());
+        if (!input) return 1;
+        inputs.emplace_back(std::move(input.value()));
+    }
+
+    auto threads = std::clamp(jobs, size_t(1), days->size());
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<DayRun>> runs{};
+    {
+        aoc::ThreadPool pool(threads);
+        for (size_t i = 0; i < days->size(); i++) {
+            runs.push_back(pool.submit([&day = days->at(i), &input = inputs[i], &params]() -> DayRun {
+                auto start = std::chrono::steady_clock::now();
+                auto answer = day.solve(input.data(), params);
+                return {std::move(answer), std::chrono::steady_clock::now() - start};
+            }));
+        }
+    }
+    auto wall = std::chrono::steady_clock::now() - start;
+
+    bool ok{true};
+    std::chrono::nanoseconds cpu{0};
+    for (size_t i = 0; i < days->size(); i++) {
+        auto run = runs[i].get();
+        auto day = days->at(i).number;
+        cpu += run.time;
+
+        fmt::print("Day {} [{}]\n", day, aoc::format_duration(run.time));
+        if (!run.answer) {
+            fmt::print("  failed\n");
+            ok = false;
+            continue;
+        }
+        if (run.answer->part1) fmt::print("  part 1: {}\n", run.answer->part1.value());
+        if (run.answer->part2) fmt::print("  part 2: {}\n", run.answer->part2.value());
+
+        if constexpr (aoc::profile::enabled) {
+            if (run.answer->part1) aoc::profile::record(fmt::format("day{} part 1", day), run.answer->part1_time());
+            if (run.answer->part2) aoc::profile::record(fmt::format("day{} part 2", day), run.answer->part2_time());
+        }
+    }
+    fmt::print("{} days in {} on {} threads (sum of solve times {})\n",
+        days->size(), aoc::format_duration(wall), threads, aoc::format_duration(cpu));
+
+    return ok ? 0 : 1;
+}
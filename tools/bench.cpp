@@ -0,0 +1,168 @@
+#include <aoc.h>
+#include <days.h>
+
+#include <cmath>
+
+#if !defined(AOC_SOURCE_DIR)
+#define AOC_SOURCE_DIR "."
+#endif
+
+// Runs every selected day in-process, `--warmup` times untimed and then
+// `--iterations` times timed, on its `dayN/input` file and reports per-part
+// latency and throughput. Usage:
+//
+//   aoc_bench [--iterations=N] [--warmup=N] [--inputs=DIR] [--json] [day...]
+//
+// Options other than the ones above are forwarded to the solvers.
+
+struct Stats {
+    uint64_t min_ns{0};
+    uint64_t median_ns{0};
+    uint64_t p99_ns{0};
+    double bytes_per_sec{0};
+};
+
+struct DayResult {
+    unsigned day{0};
+    size_t input_bytes{0};
+    std::optional<Stats> part1{};
+    std::optional<Stats> part2{};
+    Stats total{};
+};
+
+static inline Stats compute_stats(std::vector<uint64_t> samples, size_t input_bytes) {
+    Stats ret{};
+    if (samples.empty()) return ret;
+
+    std::sort(samples.begin(), samples.end());
+    auto rank = [&samples](double p) -> uint64_t {
+        auto idx = size_t(std::ceil(p * double(samples.size())));
+        return samples[std::clamp(idx, size_t(1), samples.size()) - 1];
+    };
+    ret.min_ns = samples.front();
+    ret.median_ns = rank(0.5);
+    ret.p99_ns = rank(0.99);
+    if (ret.median_ns) ret.bytes_per_sec = double(input_bytes) * 1e9 / double(ret.median_ns);
+    return ret;
+}
+
+static inline std::string format_rate(double bytes_per_sec) {
+    if (bytes_per_sec >= 1e9) return fmt::format("{:.2f} GB/s", bytes_per_sec / 1e9);
+    if (bytes_per_sec >= 1e6) return fmt::format("{:.2f} MB/s", bytes_per_sec / 1e6);
+    if (bytes_per_sec >= 1e3) return fmt::format("{:.2f} kB/s", bytes_per_sec / 1e3);
+    return fmt::format("{:.2f} B/s", bytes_per_sec);
+}
+
+static inline std::optional<DayResult> bench_day(const aoc::Day& day, const aoc::Input& input, const aoc::Params& params, size_t warmup, size_t iterations) {
+    std::optional<aoc::Answer> reference{};
+    std::vector<uint64_t> part1{};
+    std::vector<uint64_t> part2{};
+    std::vector<uint64_t> total{};
+
+    part1.reserve(iterations);
+    part2.reserve(iterations);
+    total.reserve(iterations);
+
+    for (size_t i = 0; i < warmup + iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        auto answer = day.solve(input.data(), params);
+        auto end = std::chrono::steady_clock::now();
+
+        if (!answer) {
+            fmt::print(std::cerr, "Day {} failed\n", day.number);
+            return std::nullopt;
+        }
+        if (!reference) {
+            reference = answer;
+        } else if (answer->part1 != reference->part1 || answer->part2 != reference->part2) {
+            fmt::print(std::cerr, "Day {} returned different answers on iteration {}\n", day.number, i);
+            return std::nullopt;
+        }
+        if (i < warmup) continue;
+
+        part1.push_back(answer->part1_time().count());
+        part2.push_back(answer->part2_time().count());
+        total.push_back(std::chrono::nanoseconds(end - start).count());
+    }
+
+    DayResult ret{};
+    ret.day = day.number;
+    ret.input_bytes = input.size();
+    if (reference->part1) ret.part1 = compute_stats(part1, input.size());
+    if (reference->part2) ret.part2 = compute_stats(part2, input.size());
+    ret.total = compute_stats(total, input.size());
+    return ret;
+}
+
+static inline void print_table(const std::vector<DayResult>& results) {
+    fmt::print("{:>4} {:>5} {:>10} {:>10} {:>10} {:>12}\n", "day", "part", "min", "median", "p99", "throughput");
+    const auto row = [](unsigned day, std::string_view part, const Stats& s) {
+        fmt::print("{:>4} {:>5} {:>10} {:>10} {:>10} {:>12}\n",
+            day, part,
+            aoc::format_duration(std::chrono::nanoseconds(s.min_ns)),
+            aoc::format_duration(std::chrono::nanoseconds(s.median_ns)),
+            aoc::format_duration(std::chrono::nanoseconds(s.p99_ns)),
+            format_rate(s.bytes_per_sec));
+    };
+    uint64_t sum{0};
+    for (const auto& r : results) {
+        if (r.part1) row(r.day, "1", r.part1.value());
+        if (r.part2) row(r.day, "2", r.part2.value());
+        row(r.day, "all", r.total);
+        sum += r.total.median_ns;
+    }
+    fmt::print("Sum of medians: {}\n", aoc::format_duration(std::chrono::nanoseconds(sum)));
+}
+
+static inline void print_json(const std::vector<DayResult>& results, size_t warmup, size_t iterations) {
+    const auto stats = [](const Stats& s) {
+        return fmt::format(R"({{"min_ns": {}, "median_ns": {}, "p99_ns": {}, "bytes_per_sec": {:.0f}}})",
+            s.min_ns, s.median_ns, s.p99_ns, s.bytes_per_sec);
+    };
+    fmt::print("{{\n  \"warmup\": {},\n  \"iterations\": {},\n  \"days\": [", warmup, iterations);
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        fmt::print("{}\n    {{\"day\": {}, \"input_bytes\": {}", i ? "," : "", r.day, r.input_bytes);
+        if (r.part1) fmt::print(", \"part1\": {}", stats(r.part1.value()));
+        if (r.part2) fmt::print(", \"part2\": {}", stats(r.part2.value()));
+        fmt::print(", \"total\": {}}}", stats(r.total));
+    }
+    fmt::print("\n  ]\n}}\n");
+}
+
+int main(int argc, char* argv[]) {
+    auto params = aoc::Params(argc, argv);
+    auto iterations = params.get<size_t>("iterations", 10);
+    auto warmup = params.get<size_t>("warmup", 2);
+    auto inputs = params.get<std::string_view>("inputs", AOC_SOURCE_DIR);
+    if (!iterations) {
+        fmt::print(std::cerr, "--iterations must be at least 1\n");
+        return 1;
+    }
+
+    auto days = aoc::select_days(params);
+    if (!days) return 1;
+
+    std::vector<DayResult> results{};
+    bool ok{true};
+    for (const auto& day : days.value()) {
+        auto path = fmt::format("{}/day{}/input", inputs, day.number);
+        auto input = aoc::Input::from_file(path.c_str());
+        if (!input) {
+            ok = false;
+            continue;
+        }
+
+        if (auto r = bench_day(day, input.value(), params, warmup, iterations); r)
+            results.push_back(r.value());
+        else
+            ok = false;
+    }
+
+    if (params.has("json"))
+        print_json(results, warmup, iterations);
+    else
+        print_table(results);
+
+    return ok ? 0 : 1;
+}